@@ -19,7 +19,8 @@
 
 static ZithNode *alloc_node(ZithArena *a, ZithNodeId id,
                                 ZithSourceLoc loc) {
-    auto *n = static_cast<ZithNode *>(zith_arena_alloc(a, sizeof(ZithNode)));
+    ZITH_ARENA_SITE(a, ZITH_ARENA_TAG_AST_NODES);
+    auto *n = static_cast<ZithNode *>(zith_arena_alloc_aligned(a, sizeof(ZithNode), alignof(ZithNode)));
     if (!n) return nullptr;
     memset(n, 0, sizeof(ZithNode));
     n->type = id;
@@ -30,7 +31,8 @@ static ZithNode *alloc_node(ZithArena *a, ZithNodeId id,
 // Template must be outside extern "C" — C linkage and templates are incompatible
 template<typename T>
 static T *alloc_payload(ZithArena *a, ZithNode *n) {
-    auto *p = static_cast<T *>(zith_arena_alloc(a, sizeof(T)));
+    ZITH_ARENA_SITE(a, ZITH_ARENA_TAG_AST_PAYLOADS);
+    auto *p = static_cast<T *>(zith_arena_alloc_aligned(a, sizeof(T), alignof(T)));
     if (!p) return nullptr;
     memset(p, 0, sizeof(T));
     n->data.list.ptr = p;
@@ -47,7 +49,7 @@ extern "C" {
 
 ZithNode *zith_ast_make_program(ZithArena *a,
                                         ZithNode **decls, size_t count) {
-    ZithSourceLoc root = {0, 1};
+    ZithSourceLoc root = {0};
     ZithNode *n = alloc_node(a, ZITH_NODE_PROGRAM, root);
     if (!n) return nullptr;
     n->data.list.ptr = decls;
@@ -75,7 +77,7 @@ ZithNode *zith_ast_make_identifier(ZithArena *a, ZithSourceLoc loc,
                                            const char *name, size_t len) {
     ZithNode *n = alloc_node(a, ZITH_NODE_IDENTIFIER, loc);
     if (!n) return nullptr;
-    n->data.ident.str = zith_arena_strdup(a, name);
+    n->data.ident.str = zith_arena_str(a, name, len);
     n->data.ident.len = len;
     return n;
 }
@@ -178,7 +180,7 @@ ZithNode *zith_ast_make_var_decl(ZithArena *a, const ZithSourceLoc loc,
     auto *p = alloc_payload<ZithVarPayload>(a, n);
     if (!p) return n;
     *p = decl;
-    p->name = zith_arena_strdup(a, decl.name);
+    p->name = zith_arena_str(a, decl.name, decl.name_len);
     return n;
 }
 
@@ -190,7 +192,7 @@ ZithNode *zith_ast_make_func_decl(ZithArena *a, const ZithSourceLoc loc,
     auto *p = alloc_payload<ZithFuncPayload>(a, n);
     if (!p) return n;
     *p = decl;
-    p->name = zith_arena_strdup(a, decl.name);
+    p->name = zith_arena_str(a, decl.name, decl.name_len);
     n->data.list.len = decl.param_count;
     return n;
 }
@@ -203,7 +205,7 @@ ZithNode *zith_ast_make_param(ZithArena *a, ZithSourceLoc loc,
     auto *p = alloc_payload<ZithParamPayload>(a, n);
     if (!p) return n;
     *p = param;
-    p->name = zith_arena_strdup(a, param.name);
+    p->name = zith_arena_str(a, param.name, param.name_len);
     return n;
 }
 
@@ -286,7 +288,7 @@ ZithNode *zith_ast_make_struct(ZithArena *a, ZithSourceLoc loc,
     auto *p = alloc_payload<ZithStructPayload>(a, n);
     if (!p) return n;
     *p = decl;
-    p->name = zith_arena_strdup(a, decl.name);
+    p->name = zith_arena_str(a, decl.name, decl.name_len);
     n->data.list.len = decl.field_count;
     return n;
 }
@@ -299,7 +301,7 @@ ZithNode *zith_ast_make_enum(ZithArena *a, ZithSourceLoc loc,
     auto *p = alloc_payload<ZithEnumPayload>(a, n);
     if (!p) return n;
     *p = decl;
-    p->name = zith_arena_strdup(a, decl.name);
+    p->name = zith_arena_str(a, decl.name, decl.name_len);
     n->data.list.len = decl.variant_count;
     return n;
 }
@@ -325,7 +327,7 @@ ZithNode *zith_ast_make_try_catch(ZithArena *a, ZithSourceLoc loc,
     if (!p) return n;
     *p = data;
     if (data.catch_var && data.catch_var_len)
-        p->catch_var = zith_arena_strdup(a, data.catch_var);
+        p->catch_var = zith_arena_str(a, data.catch_var, data.catch_var_len);
     return n;
 }
 
@@ -395,7 +397,7 @@ ZithNode *zith_ast_make_break(ZithArena *a, ZithSourceLoc loc,
     ZithNode *n = alloc_node(a, ZITH_NODE_BREAK, loc);
     if (!n) return nullptr;
     if (label && len) {
-        n->data.ident.str = zith_arena_strdup(a, label);
+        n->data.ident.str = zith_arena_str(a, label, len);
         n->data.ident.len = len;
     }
     return n;
@@ -406,7 +408,7 @@ ZithNode *zith_ast_make_continue(ZithArena *a, ZithSourceLoc loc,
     ZithNode *n = alloc_node(a, ZITH_NODE_CONTINUE, loc);
     if (!n) return nullptr;
     if (label && len) {
-        n->data.ident.str = zith_arena_strdup(a, label);
+        n->data.ident.str = zith_arena_str(a, label, len);
         n->data.ident.len = len;
     }
     return n;
@@ -767,8 +769,8 @@ void zith_ast_print(const ZithNode *node, int indent) {
     if (!node) return;
 
     print_indent(indent);
-    debug_print("[%s] line %zu\n",
-            zith_ast_node_name(node->type), node->loc.line);
+    debug_print("[%s] @%zu\n",
+            zith_ast_node_name(node->type), node->loc.offset);
 
     switch (node->type) {
         case ZITH_NODE_IDENTIFIER:
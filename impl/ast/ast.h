@@ -54,6 +54,8 @@ typedef struct {
     ZithNode *body; // NULL = forward declaration
     ZithVisibility visibility;
     bool is_extern;
+    struct ZithLazyUnit *lazy; // set while body is an UNBODY awaiting zith_ast_expand
+    bool body_failed; // its lazy expansion or sema reported errors
 } ZithFuncPayload;
 
 // ZITH_NODE_VAR_DECL (200) — list.ptr, list.len = 0
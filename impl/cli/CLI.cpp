@@ -13,6 +13,7 @@
 #include <vector>
 #include "../lexer/debug.h"
 #include "../ast/ast.h"
+#include "../parser/parser_context.hpp"
 
 static const char *zith_version = ZITH_VERSION;
 
@@ -132,21 +133,28 @@ static ZithArena *tokenize_file(const std::string &src_path,
                                     const char **out_source,
                                     size_t *out_source_len,
                                     bool verbose) {
-    ZithArena *arena = zith_arena_create(64 * 1024);
+    // Unidades grandes: arena reservada (contígua, huge pages) em vez da
+    // cadeia de blocos de 64 KiB
+    constexpr size_t kReservedArenaThreshold = 1024 * 1024;
+    ZithArena *arena = zith_file_size(src_path.c_str()) >= kReservedArenaThreshold
+                           ? zith_arena_create_reserved(0, ZITH_ARENA_HUGE_PAGES)
+                           : zith_arena_create(64 * 1024);
     if (!arena) {
         print_error("Failed to create memory arena");
         return nullptr;
     }
 
-    size_t file_size = 0;
-    const char *source = zith_load_file_to_arena(arena, src_path.c_str(), &file_size);
-    if (!source) {
+    // Ficheiros grandes são mapeados; o mapeamento vive até a arena ser destruída
+    ZithSourceView view;
+    if (!zith_source_view_open(arena, src_path.c_str(), &view)) {
         print_error("Failed to load file: " + src_path);
         zith_arena_destroy(arena);
         return nullptr;
     }
+    const char *source = view.data;
+    const size_t file_size = view.size;
 
-    out_stream = zith_tokenize(arena, source, file_size);
+    out_stream = zith_tokenize_parallel(arena, source, file_size, 0);
     if (!out_stream.data) {
         zith_arena_destroy(arena);
         return nullptr;
@@ -155,13 +163,33 @@ static ZithArena *tokenize_file(const std::string &src_path,
     if (verbose)
         print_info("Tokenized " + std::to_string(out_stream.len) + " tokens from " + src_path);
 
-    // Return source pointer — already in arena, no extra allocation needed
+    // Return source pointer — owned by the arena, no extra allocation needed
     if (out_source) *out_source = source;
     if (out_source_len) *out_source_len = file_size;
 
     return arena;
 }
 
+// --mem-report: contadores da arena; a divisão por site só existe em builds
+// com ZITH_ARENA_PROFILE
+static void print_mem_report(const char *label, const ZithArena *arena) {
+    ZithArenaStats s;
+    zith_arena_get_stats(arena, &s);
+
+    printf("\n[mem] %s\n", label);
+    printf("  requested     %12zu bytes\n", s.requested);
+    printf("  padding       %12zu bytes\n", s.padded);
+    printf("  used          %12zu bytes\n", s.used);
+    printf("  peak          %12zu bytes\n", s.peak);
+    printf("  reserved      %12zu bytes\n", s.reserved);
+    printf("  blocks        %12zu\n", s.blocks);
+    printf("  large allocs  %12zu\n", s.large_allocs);
+#ifdef ZITH_ARENA_PROFILE
+    for (int t = 0; t < ZITH_ARENA_TAG_COUNT; ++t)
+        printf("  %-13s %12zu bytes\n", zith_arena_tag_name(static_cast<ZithArenaTag>(t)), s.by_tag[t]);
+#endif
+}
+
 enum class RtValKind { Void, Int, Float, String, Bool };
 struct RtValue {
     RtValKind kind = RtValKind::Void;
@@ -172,7 +200,7 @@ struct RtValue {
 };
 
 struct RtContext {
-    ankerl::unordered_dense::map<std::string, ZithFuncPayload *> funcs;
+    ankerl::unordered_dense::map<std::string, ZithNode *> funcs; // FUNC_DECL
     std::vector<ankerl::unordered_dense::map<std::string, RtValue>> scopes;
 };
 
@@ -213,13 +241,16 @@ static RtValue eval_call(RtContext &ctx, ZithCallPayload *call) {
     }
     auto fn_it = ctx.funcs.find(cname);
     if (fn_it == ctx.funcs.end()) return {};
-    auto *fn = fn_it->second;
+    auto *fn = static_cast<ZithFuncPayload *>(fn_it->second->data.list.ptr);
+    // Bodies from a lazy parse are expanded on their first call
+    ZithNode *body = zith_ast_expand(fn_it->second);
+    if (!body) return {};
     ctx.scopes.push_back({});
     for (size_t i = 0; i < fn->param_count && i < call->arg_count; ++i) {
         auto *param = static_cast<ZithParamPayload *>(fn->params[i]->data.list.ptr);
         ctx.scopes.back()[std::string(param->name, param->name_len)] = eval_expr(ctx, call->args[i]);
     }
-    RtValue ret = exec_block(ctx, fn->body);
+    RtValue ret = exec_block(ctx, body);
     ctx.scopes.pop_back();
     return ret;
 }
@@ -347,7 +378,7 @@ static int run_interpreted_ast(ZithNode *ast) {
     for (size_t i = 0; i < ast->data.list.len; ++i) {
         if (decls[i] && decls[i]->type == ZITH_NODE_FUNC_DECL) {
             auto *fn = static_cast<ZithFuncPayload *>(decls[i]->data.list.ptr);
-            ctx.funcs[std::string(fn->name, fn->name_len)] = fn;
+            ctx.funcs[std::string(fn->name, fn->name_len)] = decls[i];
         }
     }
     auto it = ctx.funcs.find("main");
@@ -355,8 +386,10 @@ static int run_interpreted_ast(ZithNode *ast) {
         print_error("No 'main' function found for interpreted execution");
         return 1;
     }
+    ZithNode *body = zith_ast_expand(it->second);
+    if (!body) return 1;
     ctx.scopes.push_back({});
-    exec_block(ctx, it->second->body);
+    exec_block(ctx, body);
     ctx.scopes.pop_back();
     return 0;
 }
@@ -368,7 +401,8 @@ static int run_interpreted_ast(ZithNode *ast) {
 // check — parse + semântica, só reporta erros, não produz artefacto
 static int cmd_check(const std::string &input_file,
                      const std::string &mode_str, bool verbose,
-                     const std::vector<std::string> &include_dirs) {
+                     const std::vector<std::string> &include_dirs,
+                     bool mem_report) {
     std::string src = input_file;
 
     if (src.empty()) {
@@ -388,7 +422,9 @@ static int cmd_check(const std::string &input_file,
     ZithArena *arena = tokenize_file(src, stream, &source, &src_size, verbose);
     if (!arena) return 1;
 
-    zith_debug_tokens(stream.data, stream.len);
+    ZithLineIndex lines{};
+    zith_line_index_build(arena, source, src_size, &lines);
+    zith_debug_tokens(stream.data, stream.len, &lines);
 
     std::vector<const char *> import_roots;
     size_t import_root_count;
@@ -399,6 +435,11 @@ static int cmd_check(const std::string &input_file,
                                                    src.c_str(), stream,
                                                    import_roots.data(), import_root_count);
 
+    if (mem_report) {
+        print_mem_report("compilation arena", arena);
+        print_mem_report("parser scratch", parser_scratch());
+    }
+
     // Debug: AST dump
     if (verbose){
         if (ast) {
@@ -721,6 +762,7 @@ OPTIONS:
         --emit <ast|ir|asm|obj|bin>             Emit intermediate representation
         --target <TRIPLE>                       Target triple (e.g. x86_64-linux-gnu)
     -s, --strict                                Apply stricter rules to the compiler
+        --mem-report                            Print arena memory statistics (check)
     -v, --verbose                               Use verbose output
     -c, --color <auto|on|off>                   Set color output [default: auto]
     -h, --help                                  Show help
@@ -774,11 +816,13 @@ extern "C" int zith_run(int argc, const char *const argv[]) {
     std::string input_file;
     bool interpreted = false;
     bool fmt_check = false;
+    bool mem_report = false;
     std::string docs_output = "docs";
 
     auto *check_cmd = app.add_subcommand("check", "Parse and type-check only");
     check_cmd->add_option("input", input_file, "Source file [optional, reads toml if omitted]")
             ->check(CLI::ExistingFile);
+    check_cmd->add_flag("--mem-report", mem_report, "Print arena memory statistics");
 
     auto *compile_cmd = app.add_subcommand("compile", "Compile to object/bytecode, no linking");
     compile_cmd->add_option("input", input_file, "Source file (.zith)")
@@ -840,7 +884,7 @@ extern "C" int zith_run(int argc, const char *const argv[]) {
     if (*docs_cmd) return cmd_docs(input_file, docs_output, verbose);
     if (*fmt_cmd) return cmd_fmt(input_file, fmt_check, verbose);
     if (*test_cmd) return cmd_test(input_file, verbose);
-    if (*check_cmd) return cmd_check(input_file, mode_str, verbose, include_dirs);
+    if (*check_cmd) return cmd_check(input_file, mode_str, verbose, include_dirs, mem_report);
     if (*compile_cmd)
         return cmd_compile(input_file, output_file, mode_str,
                            interpreted, verbose, include_dirs);
@@ -11,26 +11,15 @@
 // Internal Helpers
 // ============================================================================
 
-// Finds the start and length of a specific line number (1-based)
-static bool find_source_line(const char *source, size_t source_len,
+// Start and length of the line that holds 'offset'
+static void find_source_line(const char *source, size_t source_len, const ZithLineIndex *lines,
                              size_t line_num, const char **out_start, size_t *out_len) {
-    const char *p = source;
-    const char *end = source + source_len;
-    size_t cur = 1;
-
-    // Move pointer to the start of the target line
-    while (p < end && cur < line_num) {
-        if (*p++ == '\n') cur++;
-    }
-    if (cur != line_num) return false;
+    const size_t start = lines->count ? lines->starts[line_num - 1] : 0;
+    const char *p = source + start;
+    const void *nl = memchr(p, '\n', source_len - start);
 
-    const char *line_start = p;
-    // Find the end of the line
-    while (p < end && *p != '\n') p++;
-
-    *out_start = line_start;
-    *out_len = (size_t)(p - line_start);
-    return true;
+    *out_start = p;
+    *out_len = nl ? (size_t)((const char *)nl - p) : source_len - start;
 }
 
 static const char *severity_label(ZithDiagSeverity s) {
@@ -43,6 +32,44 @@ static const char *severity_label(ZithDiagSeverity s) {
     }
 }
 
+// ============================================================================
+// C API — Line index
+// ============================================================================
+
+bool zith_line_index_build(ZithArena *arena, const char *source, size_t source_len, ZithLineIndex *out) {
+    *out = {nullptr, 0};
+    if (!arena || !source) return false;
+
+    // One memchr pass to size the table, one to fill it
+    const char *end = source + source_len;
+    size_t count = 1;
+    for (const char *p = source; (p = (const char *)memchr(p, '\n', end - p)); ++p) ++count;
+
+    auto *starts = (size_t *)zith_arena_alloc_aligned(arena, count * sizeof(size_t), alignof(size_t));
+    if (!starts) return false;
+
+    size_t k = 0;
+    starts[k++] = 0;
+    for (const char *p = source; (p = (const char *)memchr(p, '\n', end - p)); ++p)
+        starts[k++] = (size_t)(p - source) + 1;
+
+    *out = {starts, count};
+    return true;
+}
+
+ZithLineCol zith_line_index_resolve(const ZithLineIndex *index, size_t offset) {
+    if (!index || index->count == 0) return {1, offset + 1};
+
+    // Last line start <= offset
+    size_t lo = 0, hi = index->count;
+    while (hi - lo > 1) {
+        const size_t mid = lo + (hi - lo) / 2;
+        if (index->starts[mid] <= offset) lo = mid;
+        else hi = mid;
+    }
+    return {lo + 1, offset - index->starts[lo] + 1};
+}
+
 // ============================================================================
 // C API — zith_diag_print_all
 // ============================================================================
@@ -51,34 +78,39 @@ void zith_diag_print_all(const ZithDiagList *diags, const char *source,
                              size_t source_len, const char *filename) {
     if (!diags || diags->count == 0) return;
 
+    // Line/column are resolved here, once per source, not tracked by the lexer
+    ZithArena *scratch = source ? zith_arena_create(0) : nullptr;
+    ZithLineIndex lines = {nullptr, 0};
+    if (scratch) zith_line_index_build(scratch, source, source_len, &lines);
+
     for (size_t i = 0; i < diags->count; ++i) {
         const ZithDiagnostic *d = &diags->items[i];
+        const ZithLineCol lc = zith_line_index_resolve(&lines, d->loc.offset);
 
         // 1. Print the Header: file:line:col: severity: message
         fprintf(stderr, "%s:%zu:%zu: %s: %s\n",
                 filename ? filename : "<input>",
-                d->loc.line, d->loc.index,
+                lc.line, lc.column,
                 severity_label(d->severity), d->message);
 
         // 2. Print the Source Line and Caret
-        if (source && source_len > 0) {
+        if (source && source_len > 0 && d->loc.offset <= source_len) {
             const char *line_ptr = nullptr;
             size_t line_len = 0;
+            find_source_line(source, source_len, &lines, lc.line, &line_ptr, &line_len);
+
+            // Print the actual code line
+            fprintf(stderr, "  %.*s\n", (int)line_len, line_ptr);
 
-            if (find_source_line(source, source_len, d->loc.line, &line_ptr, &line_len)) {
-                // Print the actual code line
-                fprintf(stderr, "  %.*s\n", (int)line_len, line_ptr);
-
-                // Print the caret (^^^) pointing to the error
-                fprintf(stderr, "  ");
-                size_t col = d->loc.index;
-                for (size_t c = 0; c < col && c < line_len; ++c) {
-                    fputc(line_ptr[c] == '\t' ? '\t' : ' ', stderr);
-                }
-                fprintf(stderr, "^\n");
+            // Print the caret (^^^) pointing to the error
+            fprintf(stderr, "  ");
+            for (size_t c = 0; c + 1 < lc.column && c < line_len; ++c) {
+                fputc(line_ptr[c] == '\t' ? '\t' : ' ', stderr);
             }
+            fprintf(stderr, "^\n");
         }
     }
+    if (scratch) zith_arena_destroy(scratch);
 
     // 3. Print Summary
     size_t errors = 0, warnings = 0;
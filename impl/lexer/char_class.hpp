@@ -0,0 +1,108 @@
+// impl/lexer/char_class.hpp — Classificação de bytes do tokenizer
+//
+// Uma tabela constexpr de 256 entradas substitui as chamadas a <cctype>: cada
+// byte tem um conjunto de classes (bits) e uma classe de despacho, que o ciclo
+// principal usa num 'switch'. As classes são ASCII e não dependem do locale do
+// processo — bytes >= 0x80 não pertencem a nenhuma.
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace zith::detail::chars {
+    // ── Classes (bits) ──────────────────────────────────────────────────────────
+
+    enum : uint8_t {
+        kBlank      = 1u << 0,  // ' ' \t \r \v \f — sem '\n'
+        kNewline    = 1u << 1,
+        kIdentStart = 1u << 2,  // [A-Za-z_]
+        kIdentCont  = 1u << 3,  // [A-Za-z0-9_]
+        kDigit      = 1u << 4,
+        kHex        = 1u << 5,
+        kOperator   = 1u << 6,  // primeiro byte de pontuação / operador
+    };
+
+    // ── Classe de despacho do ciclo principal ───────────────────────────────────
+
+    enum class Lead : uint8_t {
+        Other,     // desconhecido
+        Blank,
+        Newline,
+        Ident,
+        Digit,
+        Quote,
+        Slash,     // comentário ou operador
+        Dot,       // número ('.5') ou operador
+        Operator,
+    };
+
+    namespace table {
+        constexpr bool in(const unsigned c, const char lo, const char hi) {
+            return c >= static_cast<unsigned char>(lo) && c <= static_cast<unsigned char>(hi);
+        }
+
+        constexpr bool is_operator(const unsigned c) {
+            for (const char op: "()[]{};,:?@#~+-*/%^&|=!<>.")
+                if (op != '\0' && c == static_cast<unsigned char>(op)) return true;
+            return false;
+        }
+
+        constexpr std::array<uint8_t, 256> make_bits() {
+            std::array<uint8_t, 256> t{};
+            for (unsigned c = 0; c < 256; ++c) {
+                const bool alpha = in(c, 'a', 'z') || in(c, 'A', 'Z');
+                const bool digit = in(c, '0', '9');
+                uint8_t bits = 0;
+                if (c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f') bits |= kBlank;
+                if (c == '\n') bits |= kNewline;
+                if (alpha || c == '_') bits |= kIdentStart | kIdentCont;
+                if (digit) bits |= kDigit | kIdentCont | kHex;
+                if (in(c, 'a', 'f') || in(c, 'A', 'F')) bits |= kHex;
+                if (is_operator(c)) bits |= kOperator;
+                t[c] = bits;
+            }
+            return t;
+        }
+
+        constexpr std::array<Lead, 256> make_lead(const std::array<uint8_t, 256> &bits) {
+            std::array<Lead, 256> t{};
+            for (unsigned c = 0; c < 256; ++c) {
+                const uint8_t b = bits[c];
+                Lead l = Lead::Other;
+                if (b & kBlank) l = Lead::Blank;
+                else if (b & kNewline) l = Lead::Newline;
+                else if (b & kIdentStart) l = Lead::Ident;
+                else if (b & kDigit) l = Lead::Digit;
+                else if (c == '"') l = Lead::Quote;
+                else if (c == '/') l = Lead::Slash;
+                else if (c == '.') l = Lead::Dot;
+                else if (b & kOperator) l = Lead::Operator;
+                t[c] = l;
+            }
+            return t;
+        }
+    } // namespace table
+
+    inline constexpr std::array<uint8_t, 256> kBits = table::make_bits();
+    inline constexpr std::array<Lead, 256> kLead = table::make_lead(kBits);
+
+    // ── Consultas ───────────────────────────────────────────────────────────────
+
+    constexpr bool has(const unsigned char c, const uint8_t cls) { return (kBits[c] & cls) != 0; }
+    constexpr Lead lead(const unsigned char c) { return kLead[c]; }
+
+    constexpr bool is_blank(const unsigned char c) { return has(c, kBlank); }
+    constexpr bool is_ident_start(const unsigned char c) { return has(c, kIdentStart); }
+    constexpr bool is_ident(const unsigned char c) { return has(c, kIdentCont); }
+    constexpr bool is_digit(const unsigned char c) { return has(c, kDigit); }
+    constexpr bool is_hex(const unsigned char c) { return has(c, kHex); }
+
+    // Só letras ASCII mudam; o resto passa intacto
+    constexpr unsigned char to_lower(const unsigned char c) {
+        return table::in(c, 'A', 'Z') ? static_cast<unsigned char>(c | 0x20) : c;
+    }
+
+    static_assert(lead('\n') == Lead::Newline && lead(' ') == Lead::Blank);
+    static_assert(lead('_') == Lead::Ident && lead('7') == Lead::Digit && lead('.') == Lead::Dot);
+    static_assert(is_hex('F') && !is_hex('g') && !is_ident(0xC3));
+} // namespace zith::detail::chars
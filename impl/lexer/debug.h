@@ -220,7 +220,9 @@ static void format_lexeme(char *out, size_t out_size,
 // zith_debug_tokens
 // ============================================================================
 
-inline void zith_debug_tokens(const ZithToken *tokens, size_t count) {
+// Sem 'lines' as posições saem como linha 1, coluna offset + 1
+inline void zith_debug_tokens(const ZithToken *tokens, size_t count,
+                              const ZithLineIndex *lines = nullptr) {
     if (!tokens) {
         debug_error("[zith_debug_tokens] null token array\n");
         return;
@@ -241,12 +243,13 @@ inline void zith_debug_tokens(const ZithToken *tokens, size_t count) {
 
         char lexeme_buf[32];
         format_lexeme(lexeme_buf, sizeof(lexeme_buf), t.lexeme.data, t.lexeme.len);
+        const ZithLineCol lc = zith_line_index_resolve(lines, t.loc.offset);
 
         debug_print(
                 " %-5zu  %-4zu  %-4zu  %-12s  %-13s  %s\n",
                 i,
-                t.loc.line,
-                t.loc.index,
+                lc.line,
+                lc.column,
                 zith_token_type_name(t.type),
                 token_category(t.type),
                 lexeme_buf
@@ -0,0 +1,124 @@
+// impl/lexer/punctuation.hpp — Operadores e delimitadores por primeiro byte
+//
+// Uma tabela constexpr de 256 entradas, indexada pelo primeiro byte, guarda
+// o token de um carácter e os (no máximo dois) operadores mais longos que
+// começam por ele, do mais longo para o mais curto. match() resolve o maior
+// operador com um acesso à tabela e uma ou duas comparações — sem hash.
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+#include "zith/zith.hpp"
+
+namespace zith::detail::punct {
+    struct Op {
+        std::string_view text;
+        ZithTokenType type;
+    };
+
+    // A mesma pontuação da tabela de keywords. '@', '#' e '~' não têm token
+    // próprio e saem como IDENTIFIER, como sempre saíram do lookup
+    inline constexpr Op kOps[] = {
+        {"...", ZITH_TOKEN_DOTS},
+        {"==", ZITH_TOKEN_EQUAL},
+        {">=", ZITH_TOKEN_GREATER_THAN_OR_EQUAL},
+        {"<=", ZITH_TOKEN_LESS_THAN_OR_EQUAL},
+        {"->", ZITH_TOKEN_ARROW},
+        {"+=", ZITH_TOKEN_PLUS_EQUAL},
+        {"-=", ZITH_TOKEN_MINUS_EQUAL},
+        {"*=", ZITH_TOKEN_MULTIPLY_EQUAL},
+        {"/=", ZITH_TOKEN_DIVIDE_EQUAL},
+        {":=", ZITH_TOKEN_DECLARATION},
+
+        {"+", ZITH_TOKEN_PLUS},
+        {"-", ZITH_TOKEN_MINUS},
+        {"*", ZITH_TOKEN_MULTIPLY},
+        {"/", ZITH_TOKEN_DIVIDE},
+        {"%", ZITH_TOKEN_MOD},
+        {"=", ZITH_TOKEN_ASSIGNMENT},
+        {"<", ZITH_TOKEN_LESS_THAN},
+        {">", ZITH_TOKEN_GREATER_THAN},
+        {"!", ZITH_TOKEN_BANG},
+        {"?", ZITH_TOKEN_QUESTION},
+
+        {"(", ZITH_TOKEN_LPAREN}, {")", ZITH_TOKEN_RPAREN},
+        {"{", ZITH_TOKEN_LBRACE}, {"}", ZITH_TOKEN_RBRACE},
+        {"[", ZITH_TOKEN_LBRACKET}, {"]", ZITH_TOKEN_RBRACKET},
+        {",", ZITH_TOKEN_COMMA}, {";", ZITH_TOKEN_SEMICOLON},
+        {":", ZITH_TOKEN_COLON}, {".", ZITH_TOKEN_DOT},
+
+        {"@", ZITH_TOKEN_IDENTIFIER}, {"#", ZITH_TOKEN_IDENTIFIER}, {"~", ZITH_TOKEN_IDENTIFIER},
+    };
+
+    // ── Tabela ──────────────────────────────────────────────────────────────────
+
+    struct Longer {
+        char rest[2];   // bytes depois do primeiro
+        uint8_t len;    // 2 ou 3
+        ZithTokenType type;
+    };
+
+    struct Entry {
+        Longer longer[2];
+        uint8_t longer_count;
+        bool has_single;
+        ZithTokenType single;
+    };
+
+    namespace table {
+        constexpr std::array<Entry, 256> make() {
+            std::array<Entry, 256> t{};
+            for (const Op &op: kOps) {
+                Entry &e = t[static_cast<unsigned char>(op.text[0])];
+                if (op.text.size() == 1) {
+                    e.has_single = true;
+                    e.single = op.type;
+                    continue;
+                }
+                if (e.longer_count == 2) throw "more than two longer operators share a first byte";
+                Longer l{{op.text[1], op.text.size() > 2 ? op.text[2] : '\0'},
+                         static_cast<uint8_t>(op.text.size()), op.type};
+                // Mais longo primeiro: é o que ganha
+                if (e.longer_count == 1 && e.longer[0].len < l.len) {
+                    e.longer[1] = e.longer[0];
+                    e.longer[0] = l;
+                } else {
+                    e.longer[e.longer_count] = l;
+                }
+                ++e.longer_count;
+            }
+            return t;
+        }
+    } // namespace table
+
+    inline constexpr std::array<Entry, 256> kTable = table::make();
+
+    // ── Consulta ────────────────────────────────────────────────────────────────
+
+    struct Match {
+        ZithTokenType type;
+        uint8_t len;    // 0: não é pontuação
+    };
+
+    // O maior operador em [p, end) (p < end)
+    constexpr Match match(const char *p, const char *end) {
+        const Entry &e = kTable[static_cast<unsigned char>(*p)];
+        const auto avail = end - p;
+        for (uint8_t k = 0; k < e.longer_count; ++k) {
+            const Longer &l = e.longer[k];
+            if (avail >= l.len && p[1] == l.rest[0] && (l.len == 2 || p[2] == l.rest[1]))
+                return {l.type, l.len};
+        }
+        if (e.has_single) return {e.single, 1};
+        return {ZITH_TOKEN_UNKNOWN, 0};
+    }
+
+    constexpr Match match(const std::string_view s) { return match(s.data(), s.data() + s.size()); }
+
+    static_assert(match("...").type == ZITH_TOKEN_DOTS && match("..").len == 1);
+    static_assert(match("->x").type == ZITH_TOKEN_ARROW && match("-=").type == ZITH_TOKEN_MINUS_EQUAL);
+    static_assert(match(":=").len == 2 && match(":").type == ZITH_TOKEN_COLON);
+    static_assert(match("&&").len == 0 && match("a").len == 0);
+} // namespace zith::detail::punct
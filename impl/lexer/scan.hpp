@@ -0,0 +1,160 @@
+// impl/lexer/scan.hpp — Scanners de bytes para o tokenizer
+//
+// Cada scanner devolve o primeiro byte em [p, end) que termina uma sequência
+// (espaço horizontal, continuação de identificador) ou que é um dos bytes
+// procurados. O trabalho é feito 32 bytes de cada vez com AVX2, 16 com SSE2,
+// e o resto (cauda e outras arquiteturas) byte a byte. Nunca lêem para lá de
+// 'end'.
+//
+// A variante é escolhida em compilação: SSE2 faz parte do x86-64 base; AVX2
+// só com -mavx2 / -march que o inclua.
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include "char_class.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define ZITH_SCAN_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ZITH_SCAN_SSE2 1
+#endif
+
+namespace zith::detail::scan {
+    // ── Classes (ASCII) ─────────────────────────────────────────────────────────
+    // Os caminhos escalares usam a mesma tabela que o ciclo principal
+
+    using chars::is_blank;
+    using chars::is_ident_start;
+    using chars::is_ident;
+
+    // Índice do primeiro bit a 1 (mask != 0)
+    inline unsigned first_set(const uint32_t mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long i;
+        _BitScanForward(&i, mask);
+        return static_cast<unsigned>(i);
+#else
+        return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+    }
+
+    // ── Máscaras por bloco ──────────────────────────────────────────────────────
+    // Bit i a 1 quando o byte i pertence à classe. Comparações com sinal: bytes
+    // >= 0x80 são negativos e ficam sempre fora dos intervalos ASCII.
+
+#ifdef ZITH_SCAN_SSE2
+    inline __m128i in_range(const __m128i v, const char lo, const char hi) {
+        return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(static_cast<char>(lo - 1))),
+                             _mm_cmplt_epi8(v, _mm_set1_epi8(static_cast<char>(hi + 1))));
+    }
+
+    inline uint32_t blank_mask(const __m128i v) {
+        const __m128i sp = _mm_cmpeq_epi8(v, _mm_set1_epi8(' '));
+        const __m128i ctl = in_range(v, '\t', '\r');  // \t \n \v \f \r
+        const __m128i nl = _mm_cmpeq_epi8(v, _mm_set1_epi8('\n'));
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(sp, _mm_andnot_si128(nl, ctl))));
+    }
+
+    inline uint32_t ident_mask(const __m128i v) {
+        const __m128i alpha = in_range(_mm_or_si128(v, _mm_set1_epi8(0x20)), 'a', 'z');
+        const __m128i digit = in_range(v, '0', '9');
+        const __m128i under = _mm_cmpeq_epi8(v, _mm_set1_epi8('_'));
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(alpha, digit), under)));
+    }
+
+    inline uint32_t eq_mask(const __m128i v, const char a) {
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(a))));
+    }
+#endif
+
+#ifdef ZITH_SCAN_AVX2
+    inline __m256i in_range(const __m256i v, const char lo, const char hi) {
+        return _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8(static_cast<char>(lo - 1))),
+                                _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(hi + 1)), v));
+    }
+
+    inline uint32_t blank_mask(const __m256i v) {
+        const __m256i sp = _mm256_cmpeq_epi8(v, _mm256_set1_epi8(' '));
+        const __m256i ctl = in_range(v, '\t', '\r');
+        const __m256i nl = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n'));
+        return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(sp, _mm256_andnot_si256(nl, ctl))));
+    }
+
+    inline uint32_t ident_mask(const __m256i v) {
+        const __m256i alpha = in_range(_mm256_or_si256(v, _mm256_set1_epi8(0x20)), 'a', 'z');
+        const __m256i digit = in_range(v, '0', '9');
+        const __m256i under = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('_'));
+        return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(alpha, digit), under)));
+    }
+
+    inline uint32_t eq_mask(const __m256i v, const char a) {
+        return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(a))));
+    }
+#endif
+
+    // Avança até ao primeiro byte que 'stop' marca: stop(bloco) devolve a
+    // máscara dos bytes que param o scan, scalar_stop(c) o mesmo para um byte
+    template<typename Stop, typename ScalarStop>
+    inline const char *scan(const char *p, const char *end, Stop stop, ScalarStop scalar_stop) {
+#ifdef ZITH_SCAN_AVX2
+        while (end - p >= 32) {
+            const uint32_t hit = stop(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)));
+            if (hit) return p + first_set(hit);
+            p += 32;
+        }
+#endif
+#ifdef ZITH_SCAN_SSE2
+        while (end - p >= 16) {
+            const uint32_t hit = stop(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p))) & 0xFFFFu;
+            if (hit) return p + first_set(hit);
+            p += 16;
+        }
+#endif
+        while (p < end && !scalar_stop(static_cast<unsigned char>(*p))) ++p;
+        return p;
+    }
+
+    // ── Scanners ────────────────────────────────────────────────────────────────
+
+    // Fim de uma sequência de espaço horizontal
+    inline const char *skip_blank(const char *p, const char *end) {
+        return scan(p, end, [](auto v) { return ~blank_mask(v); },
+                    [](const unsigned char c) { return !is_blank(c); });
+    }
+
+    // Fim de um identificador ([A-Za-z0-9_])
+    inline const char *skip_ident(const char *p, const char *end) {
+        return scan(p, end, [](auto v) { return ~ident_mask(v); },
+                    [](const unsigned char c) { return !is_ident(c); });
+    }
+
+    // Primeiro 'a' ou 'b'
+    inline const char *find2(const char *p, const char *end, const char a, const char b) {
+        return scan(p, end, [a, b](auto v) { return eq_mask(v, a) | eq_mask(v, b); },
+                    [a, b](const unsigned char c) { return c == static_cast<unsigned char>(a) ||
+                                                           c == static_cast<unsigned char>(b); });
+    }
+
+    // Primeiro 'a', 'b' ou 'c'
+    inline const char *find3(const char *p, const char *end, const char a, const char b, const char c) {
+        return scan(p, end, [a, b, c](auto v) { return eq_mask(v, a) | eq_mask(v, b) | eq_mask(v, c); },
+                    [a, b, c](const unsigned char x) { return x == static_cast<unsigned char>(a) ||
+                                                              x == static_cast<unsigned char>(b) ||
+                                                              x == static_cast<unsigned char>(c); });
+    }
+
+    // Primeiro 'a' (memchr já é vetorizado pela libc)
+    inline const char *find1(const char *p, const char *end, const char a) {
+        const void *hit = std::memchr(p, a, static_cast<size_t>(end - p));
+        return hit ? static_cast<const char *>(hit) : end;
+    }
+
+    inline const char *find_newline(const char *p, const char *end) {
+        return find1(p, end, '\n');
+    }
+} // namespace zith::detail::scan
@@ -0,0 +1,64 @@
+// impl/lexer/token_stream.cpp — Stream compacto (SoA)
+//
+// zith_tokenize_soa lexa para uma arena temporária e copia só as colunas
+// (tipo, offset, comprimento) para a arena final; os ZithToken completos são
+// libertados logo a seguir. A linha/coluna de um token é resolvida a partir
+// do offset com um ZithLineIndex criado no primeiro pedido.
+#include "zith/zith.hpp"
+
+#include <cstring>
+
+static_assert(ZITH_TOKEN_INFIX <= UINT8_MAX, "token types must fit the uint8_t column");
+
+ZithTokenStreamSoA zith_tokenize_soa(ZithArena *arena, const char *source, const size_t source_len) {
+    ZithTokenStreamSoA out{};
+    if (!arena || !source || source_len >= UINT32_MAX) return out;
+
+    ZithArena *tmp = zith_arena_create(0);
+    if (!tmp) return out;
+
+    const ZithTokenStream tokens = zith_tokenize(tmp, source, source_len);
+    if (tokens.data) {
+        ZITH_ARENA_SITE(arena, ZITH_ARENA_TAG_TOKENS);
+        const size_t n = tokens.len;
+        auto *types = static_cast<uint8_t *>(zith_arena_alloc_aligned(arena, n, 1));
+        auto *offsets = static_cast<uint32_t *>(zith_arena_alloc_aligned(arena, n * sizeof(uint32_t), alignof(uint32_t)));
+        auto *lengths = static_cast<uint32_t *>(zith_arena_alloc_aligned(arena, n * sizeof(uint32_t), alignof(uint32_t)));
+        if (types && offsets && lengths) {
+            for (size_t i = 0; i < n; ++i) {
+                const ZithToken &t = tokens.data[i];
+                types[i] = static_cast<uint8_t>(t.type);
+                offsets[i] = static_cast<uint32_t>(t.lexeme.data - source);
+                lengths[i] = static_cast<uint32_t>(t.lexeme.len);
+            }
+            out.types = types;
+            out.offsets = offsets;
+            out.lengths = lengths;
+            out.len = n;
+            out.source = source;
+            out.source_len = source_len;
+            out.arena = arena;
+        }
+    }
+
+    zith_arena_destroy(tmp);
+    return out;
+}
+
+ZithLineCol zith_token_soa_loc(ZithTokenStreamSoA *stream, const size_t i) {
+    if (!stream || i >= stream->len) return {0, 0};
+    if (!stream->lines.starts &&
+        !zith_line_index_build(stream->arena, stream->source, stream->source_len, &stream->lines))
+        return {0, 0};
+    return zith_line_index_resolve(&stream->lines, stream->offsets[i]);
+}
+
+ZithToken zith_token_soa_at(const ZithTokenStreamSoA *stream, const size_t i) {
+    if (!stream || i >= stream->len) return {{nullptr, 0}, {0}, ZITH_TOKEN_END, 0};
+    return ZithToken{
+        .lexeme = {stream->source + stream->offsets[i], stream->lengths[i]},
+        .loc = {stream->offsets[i]},
+        .type = static_cast<ZithTokenType>(stream->types[i]),
+        .keyword_id = 0
+    };
+}
@@ -1,15 +1,28 @@
 // impl/parser/tokenizer.cpp
 #include "zith/zith.hpp"
 #include "../memory/utils.hpp"
+#include "char_class.hpp"
+#include "punctuation.hpp"
+#include "scan.hpp"
 #include <string_view>
+#include <string>
+#include <charconv>
+#include <cfloat>
 #include <vector>
 #include <cstring>
+#include <algorithm>
 #include <iostream>
-
-#define ZITH_NEWLINE(loc) do { \
-    (loc)->line++;             \
-    (loc)->index = 0;          \
-} while(0)
+#include <system_error>
+#include <thread>
+#include <cerrno>
+#include <climits>
+#include <new>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
 
 #define MAX_ERRORS 50
 
@@ -22,54 +35,26 @@ namespace zith::detail {
     // Tipo específico para o Tokenizer
     using TokenList = ArenaList<ZithToken>;
 
+    // Fora da arena, para não partir o bloco contíguo dos tokens
+    using NumberList = std::vector<ZithNumber>;
+
 
     // ============================================================================
     // Helpers
     // ============================================================================
 
-    static void uint_to_str(char *buf, const size_t buf_size, uint64_t value, size_t *out_len) {
-        if (buf_size == 0) return;
-        if (value == 0) {
-            buf[0] = '0';
-            buf[1] = '\0';
-            *out_len = 1;
-            return;
-        }
-        char temp[21];
-        size_t len = 0;
-        while (value > 0 && len < sizeof(temp) - 1) {
-            temp[len++] = static_cast<char>('0' + (value % 10));
-            value /= 10;
-        }
-        const size_t out_len_val = (len < buf_size) ? len : buf_size - 1;
-        for (size_t i = 0; i < out_len_val; ++i)
-            buf[i] = temp[len - 1 - i];
-        buf[out_len_val] = '\0';
-        *out_len = out_len_val;
-    }
-
-    static const char *make_error_msg(ZithArena *arena, const char *prefix, const uint64_t line) {
-        char stack_buf[128];
-        size_t pos = 0;
-        for (const char *p = prefix; *p && pos < sizeof(stack_buf) - 22;)
-            stack_buf[pos++] = *p++;
-
-        size_t num_len = 0;
-        uint_to_str(stack_buf + pos, sizeof(stack_buf) - pos, line, &num_len);
-        pos += num_len;
-
-        char *msg = static_cast<char *>(zith_arena_alloc(arena, pos + 1));
-        if (msg) std::memcpy(msg, stack_buf, pos + 1);
-        return msg;
+    // Os tokens só guardam o offset; linha e coluna resolvem-se quando um
+    // diagnóstico as mostra
+    static ZithSourceLoc loc_at(const char *begin, const char *p) {
+        return {static_cast<size_t>(p - begin)};
     }
 
-    static ZithToken make_token(ZithArena *arena, ZithTokenType type,
-                                    std::string_view lexeme, ZithSourceLoc info) {
-        auto *buf = static_cast<char *>(zith_arena_alloc(arena, lexeme.size()));
-        if (buf && !lexeme.empty())
-            std::memcpy(buf, lexeme.data(), lexeme.size());
+    // O lexema aponta para o próprio source: nada é copiado. O source tem de
+    // viver tanto quanto os tokens (no parser vive na mesma arena ou mais)
+    static ZithToken make_token(const ZithTokenType type, const std::string_view lexeme,
+                                const ZithSourceLoc info) {
         return ZithToken{
-            .lexeme = {buf, lexeme.size()},
+            .lexeme = {lexeme.data(), lexeme.size()},
             .loc = info,
             .type = type,
             .keyword_id = 0
@@ -78,13 +63,6 @@ namespace zith::detail {
 
     // ── Char classifiers ─────────────────────────────────────────────────────────
 
-    static bool isSpace(unsigned char c) { return ::isspace(c) != 0; }
-    static bool isAlpha(unsigned char c) { return ::isalpha(c) != 0; }
-    static bool isDigit(unsigned char c) { return ::isdigit(c) != 0; }
-    static bool isAlphaNum(unsigned char c) { return ::isalnum(c) != 0; }
-    static bool isHexDigit(unsigned char c) { return ::isxdigit(c) != 0; }
-    static unsigned char toLower(unsigned char c) { return static_cast<unsigned char>(::tolower(c)); }
-
     static bool isValidEscape(char c) {
         switch (c) {
             case 'n':
@@ -100,60 +78,73 @@ namespace zith::detail {
         }
     }
 
-    // ── Forward declarations ─────────────────────────────────────────────────────
+    // ── Numbers ──────────────────────────────────────────────────────────────────
 
-    static void processIdentifier(const char *&current, const char *end,
-                                  TokenList &tokens,
-                                  ZithSourceLoc &info, ZithArena *arena);
+    static unsigned hex_value(const unsigned char c) {
+        return chars::is_digit(c) ? c - '0' : chars::to_lower(c) - 'a' + 10;
+    }
 
-    static void processString(const char *&current, const char *end,
-                              TokenList &tokens, std::vector<LexError> &error_list,
-                              ZithSourceLoc &info, ZithArena *arena);
+    // Potências de 10 exatas em double (10^22 é a última)
+    static constexpr double kPow10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+    };
 
-    static void processNumber(const char *&current, const char *end,
-                              TokenList &tokens, std::vector<LexError> &error_list,
-                              ZithSourceLoc &info, ZithArena *arena);
+    // O caminho rápido só é exato sem precisão estendida (x87)
+    static constexpr bool kExactDoubleOps = FLT_EVAL_METHOD == 0;
+
+    // [start, stop) é um literal decimal com '.' e talvez separadores; mantissa
+    // são os seus dígitos como inteiro, frac_digits os que vêm depois do ponto.
+    // Se a mantissa e a potência de 10 são ambas exatas em double, uma divisão
+    // arredonda corretamente (Clinger); o resto vai para from_chars
+    static double decimal_to_double(const char *start, const char *stop, const uint64_t mantissa,
+                                    const int frac_digits, const bool mantissa_exact) {
+        if (kExactDoubleOps && mantissa_exact && mantissa <= (uint64_t{1} << 53) && frac_digits <= 22)
+            return static_cast<double>(mantissa) / kPow10[frac_digits];
+
+        std::string digits;
+        digits.reserve(static_cast<size_t>(stop - start) + 1);
+        if (*start == '.') digits += '0';
+        for (const char *p = start; p < stop; ++p)
+            if (*p != '\'') digits += *p;
+
+        double out = 0.0;
+        std::from_chars(digits.data(), digits.data() + digits.size(), out);
+        return out;
+    }
 
-    static bool punctuation(const char *&current, const char *end,
-                            TokenList &tokens,
-                            ZithSourceLoc &info, ZithArena *arena);
+    // ── Forward declarations ─────────────────────────────────────────────────────
 
-    // ── Comments ─────────────────────────────────────────────────────────────────
+    static void processIdentifier(const char *begin, const char *&current, const char *end,
+                                  TokenList &tokens, ZithArena *arena);
 
-    static void skipSingleLine(ZithSourceLoc &info, const char *&current, const char *end) {
-        while (current < end && *current != '\n') {
-            ++current;
-            ++info.index;
-        }
-    }
+    static void processString(const char *begin, const char *&current, const char *end,
+                              TokenList &tokens, std::vector<LexError> &error_list,
+                              ZithArena *arena);
 
-    static void skipMultiLine(ZithSourceLoc &info, const char *&current, const char *end,
-                              std::vector<LexError> &error_list, ZithArena *arena) {
-        const auto start = info;
-        current += 2;
-        info.index += 2;
+    static void processNumber(const char *begin, const char *&current, const char *end,
+                              TokenList &tokens, NumberList *numbers, std::vector<LexError> &error_list,
+                              ZithArena *arena);
 
-        while (current < end) {
-            if (*current == '*' && current + 1 < end && *(current + 1) == '/') {
-                current += 2;
-                info.index += 2;
-                return;
-            }
-            if (*current == '\n')
-                ZITH_NEWLINE(&info);
-            ++current;
-            ++info.index;
-        }
-        error_list.push_back({
-            make_error_msg(arena, "Unterminated multi-line comment starting at line ", start.line),
-            start
-        });
-    }
+    static bool punctuation(const char *begin, const char *&current, const char *end,
+                            TokenList &tokens, ZithArena *arena);
 
     // ── Errors ───────────────────────────────────────────────────────────────────
 
+    // A linha e a coluna não entram na mensagem: saem do offset quando o erro
+    // é reportado
+    static void addMsgError(std::vector<LexError> &error_list, ZithArena *arena,
+                            const char *msg, const ZithSourceLoc info) {
+        if (error_list.size() >= MAX_ERRORS) return;
+
+        const size_t len = strlen(msg);
+        char *copy = static_cast<char *>(zith_arena_alloc_aligned(arena, len + 1, 1));
+        if (copy) std::memcpy(copy, msg, len + 1);
+        error_list.push_back({copy, info});
+    }
+
     static void addCharError(std::vector<LexError> &error_list, const char *base_msg,
-                             const char c, const ZithSourceLoc info, ZithArena *arena) {
+                             const char c, const char *begin, const char *at, ZithArena *arena) {
         if (error_list.size() >= MAX_ERRORS) return;
 
         char stack_buf[64];
@@ -164,146 +155,126 @@ namespace zith::detail {
         stack_buf[pos++] = c;
         stack_buf[pos++] = '\'';
         stack_buf[pos] = '\0';
-        error_list.push_back({make_error_msg(arena, stack_buf, info.line), info});
+        addMsgError(error_list, arena, stack_buf, loc_at(begin, at));
     }
 
-    static void addMsgError(std::vector<LexError> &error_list, ZithArena *arena,
-                            const char *msg, const ZithSourceLoc info) {
-        if (error_list.size() >= MAX_ERRORS) return;
+    // ── Comments ─────────────────────────────────────────────────────────────────
 
-        const size_t len = strlen(msg);
-        char *copy = static_cast<char *>(zith_arena_alloc(arena, len + 1));
-        if (copy) std::memcpy(copy, msg, len + 1);
-        error_list.push_back({copy, info});
+    static void skipSingleLine(const char *&current, const char *end) {
+        current = scan::find_newline(current, end);
+    }
+
+    static void skipMultiLine(const char *begin, const char *&current, const char *end,
+                              std::vector<LexError> &error_list, ZithArena *arena) {
+        const char *start = current;
+
+        // Procura o fecho; um '*' sem '/' a seguir faz parte do corpo
+        for (current += 2; (current = scan::find1(current, end, '*')) < end; ++current) {
+            if (current + 1 < end && *(current + 1) == '/') {
+                current += 2;
+                return;
+            }
+        }
+        addMsgError(error_list, arena, "Unterminated multi-line comment", loc_at(begin, start));
     }
 
     // ── Processors ──────────────────────────────────────────────────────────────
 
-    static void processIdentifier(const char *&current, const char *end,
-                                  TokenList &tokens,
-                                  ZithSourceLoc &info, ZithArena *arena) {
-        const ZithSourceLoc startInfo = info;
+    static void processIdentifier(const char *begin, const char *&current, const char *end,
+                                  TokenList &tokens, ZithArena *arena) {
         const char *start = current;
 
-        while (current < end && (isAlphaNum(static_cast<unsigned char>(*current)) || *current == '_')) {
-            ++current;
-            ++info.index;
-        }
+        current = scan::skip_ident(current, end);
         const std::string_view lexeme(start, current - start);
         const ZithTokenType type = zith_lookup_keyword(start, current - start);
-        tokens.push(arena, make_token(arena, type, lexeme, startInfo));
+        tokens.push(arena, make_token(type, lexeme, loc_at(begin, start)));
     }
 
-    static void processString(const char *&current, const char *end,
+    static void processString(const char *begin, const char *&current, const char *end,
                               TokenList &tokens, std::vector<LexError> &error_list,
-                              ZithSourceLoc &info, ZithArena *arena) {
-        const ZithSourceLoc startInfo = info;
+                              ZithArena *arena) {
         const char *start = current;
+        const ZithSourceLoc startInfo = loc_at(begin, start);
         ++current;
-        ++info.index;
 
         while (current < end) {
+            // Salta o corpo (quebras de linha incluídas) até ao próximo '"' ou '\\'
+            current = scan::find2(current, end, '"', '\\');
+            if (current >= end) break;
+
             if (*current == '"') {
                 ++current;
-                ++info.index;
-                tokens.push(arena, make_token(arena, ZITH_TOKEN_STRING,
+                tokens.push(arena, make_token(ZITH_TOKEN_STRING,
                                               std::string_view(start, current - start), startInfo));
                 return;
             }
 
-            if (*current == '\\') {
-                const ZithSourceLoc escapeLoc = info;
-                ++current;
-                ++info.index;
-
-                if (current >= end) {
-                    addMsgError(error_list, arena,
-                                "Unterminated escape sequence at end of file", escapeLoc);
-                    // Fall through to emit error token below
-                    break;
-                }
+            const char *escape = current;
+            ++current;
 
-                if (!isValidEscape(*current)) {
-                    char msg_buf[64];
-                    size_t pos = 0;
-                    const char *pfx = "Invalid escape sequence '\\";
-                    for (const char *p = pfx; *p && pos < sizeof(msg_buf) - 2;) msg_buf[pos++] = *p++;
-                    if (pos < sizeof(msg_buf) - 1) msg_buf[pos++] = *current;
-                    if (pos < sizeof(msg_buf) - 1) msg_buf[pos++] = '\'';
-                    msg_buf[pos] = '\0';
-                    error_list.push_back({
-                        make_error_msg(arena, msg_buf, escapeLoc.line),
-                        escapeLoc
-                    });
-                }
-                ++current;
-                ++info.index;
-                continue;
+            if (current >= end) {
+                addMsgError(error_list, arena,
+                            "Unterminated escape sequence at end of file", loc_at(begin, escape));
+                // Fall through to emit error token below
+                break;
             }
 
-            if (*current == '\n')
-                ZITH_NEWLINE(&info);
+            if (!isValidEscape(*current)) {
+                char msg_buf[64];
+                size_t pos = 0;
+                const char *pfx = "Invalid escape sequence '\\";
+                for (const char *p = pfx; *p && pos < sizeof(msg_buf) - 2;) msg_buf[pos++] = *p++;
+                if (pos < sizeof(msg_buf) - 1) msg_buf[pos++] = *current;
+                if (pos < sizeof(msg_buf) - 1) msg_buf[pos++] = '\'';
+                msg_buf[pos] = '\0';
+                addMsgError(error_list, arena, msg_buf, loc_at(begin, escape));
+            }
             ++current;
-            ++info.index;
         }
 
         // Only reached on unterminated string (EOF without closing '"')
-        error_list.push_back({
-            make_error_msg(arena, "Unterminated string literal starting at line ", startInfo.line),
-            startInfo
-        });
-        tokens.push(arena, make_token(arena, ZITH_TOKEN_STRING,
+        addMsgError(error_list, arena, "Unterminated string literal", startInfo);
+        tokens.push(arena, make_token(ZITH_TOKEN_STRING,
                                       std::string_view(start, current - start), startInfo));
     }
 
-    static void processNumber(const char *&current, const char *end,
-                              TokenList &tokens, std::vector<LexError> &error_list,
-                              ZithSourceLoc &info, ZithArena *arena) {
+    static void processNumber(const char *begin, const char *&current, const char *end,
+                              TokenList &tokens, NumberList *numbers, std::vector<LexError> &error_list,
+                              ZithArena *arena) {
         const char *start = current;
-        const ZithSourceLoc startInfo = info;
+        const ZithSourceLoc startInfo = loc_at(begin, start);
+        const size_t errors_before = error_list.size();
 
         enum class Base { Decimal, Hex, Binary, Octal } base = Base::Decimal;
 
         // ── Detect base prefix ────────────────────────────────────────────────────
         if (*current == '0' && current + 1 < end) {
-            const char next = static_cast<char>(toLower(static_cast<unsigned char>(*(current + 1))));
+            const char next = static_cast<char>(chars::to_lower(static_cast<unsigned char>(*(current + 1))));
 
             if (next == 'x') {
                 base = Base::Hex;
                 current += 2;
-                info.index += 2;
-                if (current >= end || !isHexDigit(static_cast<unsigned char>(*current))) {
-                    error_list.push_back({
-                        make_error_msg(arena, "Hex literal '0x' has no digits at line ", startInfo.line),
-                        startInfo
-                    });
-                    tokens.push(arena, make_token(arena, ZITH_TOKEN_HEXADECIMAL,
+                if (current >= end || !chars::is_hex(static_cast<unsigned char>(*current))) {
+                    addMsgError(error_list, arena, "Hex literal '0x' has no digits", startInfo);
+                    tokens.push(arena, make_token(ZITH_TOKEN_HEXADECIMAL,
                                                   std::string_view(start, current - start), startInfo));
                     return;
                 }
             } else if (next == 'b') {
                 base = Base::Binary;
                 current += 2;
-                info.index += 2;
                 if (current >= end || (*current != '0' && *current != '1')) {
-                    error_list.push_back({
-                        make_error_msg(arena, "Binary literal '0b' has no digits at line ", startInfo.line),
-                        startInfo
-                    });
-                    tokens.push(arena, make_token(arena, ZITH_TOKEN_BINARY,
+                    addMsgError(error_list, arena, "Binary literal '0b' has no digits", startInfo);
+                    tokens.push(arena, make_token(ZITH_TOKEN_BINARY,
                                                   std::string_view(start, current - start), startInfo));
                     return;
                 }
             } else if (next == 'o') {
                 base = Base::Octal;
                 current += 2;
-                info.index += 2;
                 if (current >= end || *current < '0' || *current > '7') {
-                    error_list.push_back({
-                        make_error_msg(arena, "Octal literal '0o' has no digits at line ", startInfo.line),
-                        startInfo
-                    });
-                    tokens.push(arena, make_token(arena, ZITH_TOKEN_OCTAL,
+                    addMsgError(error_list, arena, "Octal literal '0o' has no digits", startInfo);
+                    tokens.push(arena, make_token(ZITH_TOKEN_OCTAL,
                                                   std::string_view(start, current - start), startInfo));
                     return;
                 }
@@ -313,93 +284,94 @@ namespace zith::detail {
         bool isFloat = false;
         bool prev_is_separator = false;
 
+        // O valor é acumulado enquanto os dígitos são validados
+        uint64_t value = 0;
+        bool overflow = false;
+        int frac_digits = 0;
+
         while (current < end) {
             const auto c = static_cast<unsigned char>(*current);
 
             if (c == '\'') {
                 if (prev_is_separator) {
-                    error_list.push_back({
-                        make_error_msg(arena, "Consecutive separators in numeric literal at line ", info.line),
-                        info
-                    });
+                    addMsgError(error_list, arena, "Consecutive separators in numeric literal",
+                                loc_at(begin, current));
                 }
                 prev_is_separator = true;
                 ++current;
-                ++info.index;
                 continue;
             }
 
             switch (base) {
                 case Base::Hex:
-                    if (!isHexDigit(c)) goto done;
+                    if (!chars::is_hex(c)) goto done;
+                    overflow |= (value >> 60) != 0;
+                    value = value << 4 | hex_value(c);
                     break;
 
                 case Base::Binary:
                     if (c != '0' && c != '1') goto done;
+                    overflow |= (value >> 63) != 0;
+                    value = value << 1 | (c - '0');
                     break;
 
                 case Base::Octal:
                     if (c < '0' || c > '7') {
                         // FIX: detect 8/9 as invalid octal digit (single advance, single error)
                         if (c == '8' || c == '9') {
-                            error_list.push_back({
-                                make_error_msg(arena, "Invalid digit in octal literal at line ", info.line),
-                                info
-                            });
+                            addMsgError(error_list, arena, "Invalid digit in octal literal",
+                                        loc_at(begin, current));
                             ++current;
-                            ++info.index;
                         }
                         goto done;
                     }
+                    overflow |= (value >> 61) != 0;
+                    value = value << 3 | (c - '0');
                     break;
 
                 case Base::Decimal:
                     if (c == '.') {
                         if (isFloat) goto done;
-                        if (!(current + 1 < end && isDigit(static_cast<unsigned char>(*(current + 1)))))
+                        if (!(current + 1 < end && chars::is_digit(static_cast<unsigned char>(*(current + 1)))))
                             goto done;
                         isFloat = true;
-                    } else if (!isDigit(c)) {
+                    } else if (!chars::is_digit(c)) {
                         goto done;
+                    } else {
+                        const unsigned d = c - '0';
+                        if (value > (UINT64_MAX - d) / 10) overflow = true;
+                        else value = value * 10 + d;
+                        frac_digits += isFloat;
                     }
                     break;
             }
 
             prev_is_separator = false;
             ++current;
-            ++info.index;
         }
 
     done:
+        if (overflow && !isFloat)
+            addMsgError(error_list, arena, "Integer literal does not fit in 64 bits", startInfo);
+
         if (prev_is_separator) {
-            error_list.push_back({
-                make_error_msg(arena, "Trailing separator in numeric literal at line ", info.line),
-                info
-            });
+            addMsgError(error_list, arena, "Trailing separator in numeric literal", loc_at(begin, current));
         }
 
         // Detect invalid suffix (e.g. 123abc)
-        if (current < end && (isAlpha(static_cast<unsigned char>(*current)) || *current == '_')) {
+        if (current < end && chars::is_ident_start(static_cast<unsigned char>(*current))) {
             const char *suffixStart = current;
-            const ZithSourceLoc suffixLoc = info;
-
-            while (current < end && (isAlphaNum(static_cast<unsigned char>(*current)) || *current == '_')) {
-                ++current;
-                ++info.index;
-            }
+            current = scan::skip_ident(current, end);
 
             char msg_buf[160];
             size_t pos = 0;
             for (const char *p = "Invalid suffix '"; *p && pos < sizeof(msg_buf) - 1;) msg_buf[pos++] = *p++;
             for (const char *p = suffixStart; p < current && pos < sizeof(msg_buf) - 1;) msg_buf[pos++] = *p++;
-            for (const char *p = "' on numeric literal at line "; *p && pos < sizeof(msg_buf) - 1;)
+            for (const char *p = "' on numeric literal"; *p && pos < sizeof(msg_buf) - 1;)
                 msg_buf[pos++] = *p++;
             msg_buf[pos] = '\0';
 
-            error_list.push_back({
-                make_error_msg(arena, msg_buf, suffixLoc.line),
-                suffixLoc
-            });
+            addMsgError(error_list, arena, msg_buf, loc_at(begin, suffixStart));
         }
 
         ZithTokenType type = ZITH_TOKEN_NUMBER;
@@ -414,133 +386,152 @@ namespace zith::detail {
                 break;
         }
 
-        tokens.push(arena, make_token(arena, type,
+        tokens.push(arena, make_token(type,
                                       std::string_view(start, current - start), startInfo));
-    }
 
-    static bool punctuation(const char *&current, const char *end,
-                            TokenList &tokens,
-                            ZithSourceLoc &info, ZithArena *arena) {
-        const char c = *current;
-
-        // Single-character tokens — no lookahead needed
-        switch (c) {
-            case '(':
-            case ')':
-            case '{':
-            case '}':
-            case '[':
-            case ']':
-            case ';':
-            case ',':
-            case ':':
-            case '?':
-            case '@':
-            case '#':
-            case '~':
-                tokens.push(arena, make_token(arena, zith_lookup_keyword(&c, 1),
-                                              std::string_view(&c, 1), info));
-                ++current;
-                ++info.index;
-                return true;
-
-            case '+':
-            case '-':
-            case '*':
-            case '/':
-            case '%':
-            case '^':
-            case '&':
-            case '|':
-            case '=':
-            case '!':
-            case '<':
-            case '>':
-            case '.':
-                break;
-
-            default:
-                return false;
-        }
-
-        // FIX: capture loc *before* advancing so the stored position is correct
-        const ZithSourceLoc startInfo = info;
-
-        for (const int len: {3, 2, 1}) {
-            if (current + len > end) continue;
-            const auto t = zith_lookup_keyword(current, static_cast<size_t>(len));
-            if (t != ZITH_TOKEN_IDENTIFIER) {
-                const std::string_view view(current, static_cast<size_t>(len));
-                current += len;
-                info.index += static_cast<size_t>(len);
-                tokens.push(arena, make_token(arena, t, view, startInfo)); // use startInfo, not info
-                return true;
+        if (numbers && error_list.size() == errors_before) {
+            ZithNumber num{startInfo.offset, ZITH_NUMBER_UINT, {}};
+            if (isFloat) {
+                num.kind = ZITH_NUMBER_FLOAT;
+                num.value.f64 = decimal_to_double(start, current, value, frac_digits, !overflow);
+            } else if (base == Base::Decimal && value <= INT64_MAX) {
+                num.kind = ZITH_NUMBER_INT;
+                num.value.i64 = static_cast<int64_t>(value);
+            } else {
+                num.value.u64 = value;
             }
+            numbers->push_back(num);
         }
-        return false;
     }
 
-    // ── Main Loop ───────────────────────────────────────────────────────────────
+    static bool punctuation(const char *begin, const char *&current, const char *end,
+                            TokenList &tokens, ZithArena *arena) {
+        const punct::Match m = punct::match(current, end);
+        if (m.len == 0) return false;
 
-    static void tokenize(std::string_view src, ZithArena *arena,
-                         TokenList &tokens, std::vector<LexError> &error_list) {
-        tokens.init(arena, 64);
+        tokens.push(arena, make_token(m.type, std::string_view(current, m.len), loc_at(begin, current)));
+        current += m.len;
+        return true;
+    }
 
-        ZithSourceLoc info{0, 1};
-        const char *current = src.data();
-        const char *end = src.data() + src.size();
+    // ── Main Loop ───────────────────────────────────────────────────────────────
 
+    // Lexa a partir de 'current' até 'end'. O lexer não tem estado além da
+    // posição, por isso pode começar em qualquer início de token e parar quando
+    // sync(current) disser que o resto já é conhecido. Devolve essa posição, ou
+    // nullptr ao chegar ao fim (sem END). Os valores dos literais numéricos vão
+    // para 'numbers', quando não é nulo
+    template<typename Sync>
+    static const char *lex(const char *begin, const char *current, const char *end, ZithArena *arena,
+                           TokenList &tokens, NumberList *numbers, std::vector<LexError> &error_list,
+                           Sync sync) {
         while (current < end) {
+            if (sync(current)) return current;
+
             const auto c = static_cast<unsigned char>(*current);
 
-            if (isSpace(c)) {
-                if (*current == '\n')
-                    ZITH_NEWLINE(&info);
-                ++current;
-                ++info.index;
-                continue;
-            }
+            // Um acesso à tabela decide o caminho; os scanners usam as mesmas classes
+            switch (chars::lead(c)) {
+                case chars::Lead::Newline:
+                    ++current;
+                    continue;
 
-            if (*current == '/' && current + 1 < end) {
-                if (*(current + 1) == '/') {
-                    skipSingleLine(info, current, end);
+                case chars::Lead::Blank:
+                    // Indentação e espaços: o bloco inteiro de uma vez
+                    current = scan::skip_blank(current, end);
                     continue;
-                }
-                if (*(current + 1) == '*') {
-                    skipMultiLine(info, current, end, error_list, arena);
+
+                case chars::Lead::Ident:
+                    processIdentifier(begin, current, end, tokens, arena);
                     continue;
-                }
-            }
 
-            if (isAlpha(c) || *current == '_') {
-                processIdentifier(current, end, tokens, info, arena);
-                continue;
-            }
+                case chars::Lead::Digit:
+                    processNumber(begin, current, end, tokens, numbers, error_list, arena);
+                    continue;
 
-            if (isDigit(c) || (*current == '.' && current + 1 < end &&
-                               isDigit(static_cast<unsigned char>(*(current + 1))))) {
-                processNumber(current, end, tokens, error_list, info, arena);
-                continue;
-            }
+                case chars::Lead::Quote:
+                    processString(begin, current, end, tokens, error_list, arena);
+                    continue;
 
-            if (*current == '"') {
-                processString(current, end, tokens, error_list, info, arena);
-                continue;
-            }
+                case chars::Lead::Slash:
+                    if (current + 1 < end && *(current + 1) == '/') {
+                        skipSingleLine(current, end);
+                        continue;
+                    }
+                    if (current + 1 < end && *(current + 1) == '*') {
+                        skipMultiLine(begin, current, end, error_list, arena);
+                        continue;
+                    }
+                    if (punctuation(begin, current, end, tokens, arena)) continue;
+                    break;
 
-            if (punctuation(current, end, tokens, info, arena))
-                continue;
+                case chars::Lead::Dot:
+                    if (current + 1 < end && chars::is_digit(static_cast<unsigned char>(*(current + 1)))) {
+                        processNumber(begin, current, end, tokens, numbers, error_list, arena);
+                        continue;
+                    }
+                    if (punctuation(begin, current, end, tokens, arena)) continue;
+                    break;
+
+                case chars::Lead::Operator:
+                    if (punctuation(begin, current, end, tokens, arena)) continue;
+                    break;
 
-            addCharError(error_list, "Unknown character ", *current, info, arena);
-            tokens.push(arena, make_token(arena, ZITH_TOKEN_UNKNOWN,
-                                          std::string_view(current, 1), info));
+                case chars::Lead::Other:
+                    break;
+            }
+
+            addCharError(error_list, "Unknown character ", *current, begin, current, arena);
+            tokens.push(arena, make_token(ZITH_TOKEN_UNKNOWN,
+                                          std::string_view(current, 1), loc_at(begin, current)));
             ++current;
-            ++info.index;
 
             if (error_list.size() >= MAX_ERRORS) break;
         }
+        return nullptr;
+    }
 
-        tokens.push(arena, make_token(arena, ZITH_TOKEN_END, std::string_view{}, info));
+    static void tokenize(std::string_view src, ZithArena *arena, TokenList &tokens,
+                         NumberList *numbers, std::vector<LexError> &error_list) {
+        tokens.init(arena, 64);
+
+        const char *begin = src.data();
+        const char *end = begin + src.size();
+        lex(begin, begin, end, arena, tokens, numbers, error_list, [](const char *) { return false; });
+        tokens.push(arena, make_token(ZITH_TOKEN_END, std::string_view(end, 0), loc_at(begin, end)));
+    }
+
+    static void report(const std::vector<LexError> &error_list, ZithArena *arena,
+                       const char *source, const size_t source_len) {
+        ZithLineIndex lines{};
+        zith_line_index_build(arena, source, source_len, &lines);
+        for (const auto &err: error_list) {
+            const ZithLineCol lc = zith_line_index_resolve(&lines, err.info.offset);
+            std::cerr << "Lexical error (line " << lc.line
+                    << ", col " << lc.column << "): " << err.msg << '\n';
+        }
+    }
+
+    // Coluna de tipos para o lookahead do parser
+    static const uint8_t *type_column(ZithArena *arena, const ZithToken *tokens, const size_t count) {
+        auto *types = static_cast<uint8_t *>(zith_arena_alloc_aligned(arena, count, 1));
+        if (types)
+            for (size_t i = 0; i < count; ++i) types[i] = static_cast<uint8_t>(tokens[i].type);
+        return types;
+    }
+
+    static const ZithNumber *number_table(ZithArena *arena, const NumberList &numbers) {
+        if (numbers.empty()) return nullptr;
+        auto *out = static_cast<ZithNumber *>(
+            zith_arena_alloc_aligned(arena, numbers.size() * sizeof(ZithNumber), alignof(ZithNumber)));
+        if (out) std::memcpy(out, numbers.data(), numbers.size() * sizeof(ZithNumber));
+        return out;
+    }
+
+    static ZithTokenStream make_stream(ZithArena *arena, const ZithToken *tokens, const size_t count,
+                                       const NumberList &numbers) {
+        const ZithNumber *table = number_table(arena, numbers);
+        return {tokens, count, type_column(arena, tokens, count), table, table ? numbers.size() : 0};
     }
 } // namespace zith::detail
 
@@ -550,26 +541,504 @@ namespace zith::detail {
 // ============================================================================
 
 ZithTokenStream zith_tokenize(ZithArena *arena, const char *source, const size_t source_len) {
-    if (!arena || !source) return {nullptr, 0};
+    if (!arena || !source) return {};
+
+    ZITH_ARENA_SITE(arena, ZITH_ARENA_TAG_TOKENS);
+
+    // A failed lex returns nothing, so everything it allocated is reclaimed
+    const ZithArenaMark mark = zith_arena_mark(arena);
 
     std::vector<zith::detail::LexError> error_list;
     zith::detail::TokenList tokens;
+    zith::detail::NumberList numbers;
 
-    zith::detail::tokenize(std::string_view(source, source_len), arena, tokens, error_list);
+    zith::detail::tokenize(std::string_view(source, source_len), arena, tokens, &numbers, error_list);
 
     if (!error_list.empty()) {
-        for (const auto &err: error_list)
-            std::cerr << "Lexical error (line " << err.info.line
-                    << ", col " << err.info.index << "): " << err.msg << '\n';
-        return {nullptr, 0};
+        zith::detail::report(error_list, arena, source, source_len);
+        zith_arena_rewind(arena, mark);
+        return {};
     }
 
     size_t count = 0;
-    ZithToken *flat_data = tokens.flatten(arena, &count);
+    ZithToken *flat_data = tokens.take_contiguous(arena, &count);
+    return zith::detail::make_stream(arena, flat_data, count, numbers);
+}
+
+const ZithNumber *zith_token_number(const ZithTokenStream *stream, const size_t offset) {
+    if (!stream || !stream->numbers) return nullptr;
+    const ZithNumber *first = stream->numbers;
+    const ZithNumber *last = first + stream->number_count;
+    const ZithNumber *it = std::lower_bound(first, last, offset,
+                                            [](const ZithNumber &n, const size_t off) { return n.offset < off; });
+    return it != last && it->offset == offset ? it : nullptr;
+}
+
+// Bytes after a token's end that can still change how it lexes: '.' then '..'
+// becomes '...', '1' then '.5' becomes '1.5'. Two would do; the third is slack
+static constexpr size_t kLexLookahead = 3;
+
+ZithTokenStream zith_tokenize_incremental(ZithArena *arena, const ZithTokenStream prev,
+                                          const ZithSourceEdit edit,
+                                          const char *source, const size_t source_len) {
+    if (!arena || !source) return {};
+
+    // Without a usable previous stream or a consistent edit, lex it all
+    const size_t old_len = prev.data && prev.len ? prev.data[prev.len - 1].loc.offset : 0;
+    if (!prev.data || prev.len == 0 || prev.data[prev.len - 1].type != ZITH_TOKEN_END ||
+        edit.start > edit.old_end || edit.old_end > old_len ||
+        edit.start > edit.new_end || edit.new_end > source_len ||
+        old_len - edit.old_end != source_len - edit.new_end)
+        return zith_tokenize(arena, source, source_len);
+
+    ZITH_ARENA_SITE(arena, ZITH_ARENA_TAG_TOKENS);
+    const ZithArenaMark mark = zith_arena_mark(arena);
+
+    // Restart at the first token the edit can reach: tokens that end (plus
+    // lookahead) before it are kept as they are
+    size_t first = 0;
+    while (first + 1 < prev.len &&
+           prev.data[first].loc.offset + prev.data[first].lexeme.len + kLexLookahead <= edit.start)
+        ++first;
+
+    const char *begin = source;
+    const char *end = source + source_len;
+    const ptrdiff_t delta = static_cast<ptrdiff_t>(edit.new_end) - static_cast<ptrdiff_t>(edit.old_end);
+
+    // Resynchronized once a new token starts, past the edit, where an old one
+    // started: the bytes from there on are the same, so the tokens are too
+    size_t resume = prev.len;
+    size_t j = first;
+    auto sync = [&](const char *at) {
+        const auto pos = static_cast<size_t>(at - begin);
+        if (pos < edit.new_end) return false;
+        const size_t old_pos = static_cast<size_t>(static_cast<ptrdiff_t>(pos) - delta);
+        while (j + 1 < prev.len && prev.data[j].loc.offset < old_pos) ++j;
+        if (j + 1 < prev.len && prev.data[j].loc.offset == old_pos) {
+            resume = j;
+            return true;
+        }
+        return false;
+    };
+
+    std::vector<zith::detail::LexError> error_list;
+    zith::detail::TokenList fresh;
+    zith::detail::NumberList numbers;
+    fresh.init(arena, 16);
+    // Between two tokens there is only blank space and comments, so lexing
+    // resumes right after the last kept token
+    const size_t restart = first == 0 ? 0 : prev.data[first - 1].loc.offset + prev.data[first - 1].lexeme.len;
+    // Number values of the kept prefix come first, then the re-lexed ones
+    for (size_t k = 0; k < prev.number_count && prev.numbers[k].offset < restart; ++k)
+        numbers.push_back(prev.numbers[k]);
+    if (!zith::detail::lex(begin, begin + restart, end, arena, fresh, &numbers, error_list, sync))
+        fresh.push(arena, zith::detail::make_token(ZITH_TOKEN_END, std::string_view(end, 0),
+                                                   zith::detail::loc_at(begin, end)));
+
+    if (!error_list.empty()) {
+        zith::detail::report(error_list, arena, source, source_len);
+        zith_arena_rewind(arena, mark);
+        return {};
+    }
+
+    // Splice: kept prefix, re-lexed middle, shifted suffix. Lexemes are
+    // re-pointed at the new source (they are views into it)
+    const size_t tail = prev.len - resume;
+    const size_t count = first + fresh.size() + tail;
+    auto *out = static_cast<ZithToken *>(zith_arena_alloc_aligned(arena, count * sizeof(ZithToken), alignof(ZithToken)));
+    auto *types = static_cast<uint8_t *>(zith_arena_alloc_aligned(arena, count, 1));
+    if (!out || !types) {
+        zith_arena_rewind(arena, mark);
+        return {};
+    }
+
+    size_t n = 0;
+    for (size_t i = 0; i < first; ++i, ++n) {
+        out[n] = prev.data[i];
+        out[n].lexeme.data = source + out[n].loc.offset;
+    }
+    for (const ZithToken &t: fresh) out[n++] = t;
+    for (size_t i = resume; i < prev.len; ++i, ++n) {
+        out[n] = prev.data[i];
+        out[n].loc.offset = static_cast<size_t>(static_cast<ptrdiff_t>(out[n].loc.offset) + delta);
+        out[n].lexeme.data = source + out[n].loc.offset;
+    }
+    for (size_t i = 0; i < count; ++i) types[i] = static_cast<uint8_t>(out[i].type);
+
+    // ...and those of the reused suffix, shifted like its tokens
+    if (resume < prev.len) {
+        const size_t from = prev.data[resume].loc.offset;
+        for (size_t k = 0; k < prev.number_count; ++k) {
+            if (prev.numbers[k].offset < from) continue;
+            ZithNumber num = prev.numbers[k];
+            num.offset = static_cast<size_t>(static_cast<ptrdiff_t>(num.offset) + delta);
+            numbers.push_back(num);
+        }
+    }
+    const ZithNumber *table = zith::detail::number_table(arena, numbers);
+
+    return {out, count, types, table, table ? numbers.size() : 0};
+}
+
+
+// ============================================================================
+// Parallel
+// ============================================================================
+
+namespace zith::detail {
+    // Chunk ends: just past newlines that a pre-pass sees outside strings and
+    // comments, at least 'target' bytes apart. The last end is source_len.
+    static std::vector<size_t> split_points(const char *source, const size_t source_len, const size_t target) {
+        std::vector<size_t> ends;
+        const char *begin = source;
+        const char *end = source + source_len;
+        const char *p = source;
+        const char *want = begin + target;
+
+        while (p < end) {
+            // Outside strings/comments: only '"', '/' and — past the target — '\n' matter
+            p = p < want ? scan::find2(p, end, '"', '/') : scan::find3(p, end, '"', '/', '\n');
+            if (p >= end) break;
+
+            if (*p == '\n') {
+                ends.push_back(static_cast<size_t>(p + 1 - begin));
+                want = p + 1 + target;
+                ++p;
+            } else if (*p == '"') {
+                // Skip the string; an escape hides the byte after it
+                for (++p; (p = scan::find2(p, end, '"', '\\')) < end && *p == '\\'; p += 2)
+                    if (p + 1 >= end) { p = end; break; }
+                if (p < end) ++p;
+            } else if (p + 1 < end && p[1] == '/') {
+                p = scan::find_newline(p, end);
+            } else if (p + 1 < end && p[1] == '*') {
+                for (p += 2; (p = scan::find1(p, end, '*')) < end; ++p)
+                    if (p + 1 < end && p[1] == '/') { p += 2; break; }
+            } else {
+                ++p;
+            }
+        }
+        if (ends.empty() || ends.back() != source_len) ends.push_back(source_len);
+        return ends;
+    }
+} // namespace zith::detail
+
+// Below this a single thread lexes faster than it can hand out chunks
+static constexpr size_t kParallelLexMinChunk = 1024 * 1024;
+
+ZithTokenStream zith_tokenize_parallel(ZithArena *arena, const char *source, const size_t source_len,
+                                       size_t threads) {
+    if (!arena || !source) return {};
+
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    const size_t chunks_wanted = std::min(threads, source_len / kParallelLexMinChunk);
+    if (chunks_wanted < 2) return zith_tokenize(arena, source, source_len);
+
+    const std::vector<size_t> ends = zith::detail::split_points(source, source_len, source_len / chunks_wanted);
+    const size_t n = ends.size();
+    if (n < 2) return zith_tokenize(arena, source, source_len);
+
+    // One arena, token list and error list per chunk. Offsets are already
+    // global: every chunk is lexed against the same 'begin'
+    struct Chunk {
+        ZithArena *arena = nullptr;
+        zith::detail::TokenList tokens;
+        zith::detail::NumberList numbers;
+        std::vector<zith::detail::LexError> errors;
+    };
+    std::vector<Chunk> chunks(n);
+    for (auto &c: chunks) {
+        c.arena = zith_arena_create(0);
+        if (!c.arena) {
+            for (auto &d: chunks) if (d.arena) zith_arena_destroy(d.arena);
+            return zith_tokenize(arena, source, source_len);
+        }
+    }
+
+    auto work = [&](const size_t i) {
+        Chunk &c = chunks[i];
+        const char *begin = source;
+        c.tokens.init(c.arena, 1024);
+        zith::detail::lex(begin, begin + (i ? ends[i - 1] : 0), begin + ends[i], c.arena, c.tokens, &c.numbers,
+                          c.errors, [](const char *) { return false; });
+    };
+
+    std::vector<std::thread> workers;
+    size_t spawned = 1;
+    for (; spawned < n; ++spawned) {
+        try {
+            workers.emplace_back(work, spawned);
+        } catch (const std::system_error &) {
+            break;  // no more threads: the calling thread lexes the rest
+        }
+    }
+    work(0);
+    for (size_t i = spawned; i < n; ++i) work(i);
+    for (auto &t: workers) t.join();
+
+    // A split inside a string or comment the pre-pass misjudged shows up as an
+    // unterminated one at a chunk end; any error is re-lexed serially so the
+    // report is exactly the serial one
+    bool failed = false;
+    size_t count = 1;  // END
+    for (const auto &c: chunks) {
+        failed |= !c.errors.empty();
+        count += c.tokens.size();
+    }
+
+    ZithTokenStream out{};
+    if (!failed) {
+        ZITH_ARENA_SITE(arena, ZITH_ARENA_TAG_TOKENS);
+        auto *tokens = static_cast<ZithToken *>(
+            zith_arena_alloc_aligned(arena, count * sizeof(ZithToken), alignof(ZithToken)));
+        if (tokens) {
+            size_t k = 0;
+            for (const auto &c: chunks)
+                for (const ZithToken &t: c.tokens) tokens[k++] = t;
+            tokens[k] = zith::detail::make_token(ZITH_TOKEN_END, std::string_view(source + source_len, 0),
+                                                 zith::detail::loc_at(source, source + source_len));
+            zith::detail::NumberList numbers;
+            for (const auto &c: chunks) numbers.insert(numbers.end(), c.numbers.begin(), c.numbers.end());
+            out = zith::detail::make_stream(arena, tokens, count, numbers);
+        }
+    }
+    for (auto &c: chunks) zith_arena_destroy(c.arena);
 
-    return {flat_data, count};
+    return out.data ? out : zith_tokenize(arena, source, source_len);
 }
 
+// ============================================================================
+// Streaming
+// ============================================================================
+
+// Ring of handed-out and peeked tokens; slots are reused only once a token is
+// 2 * ZITH_LEXER_LOOKAHEAD calls old
+static constexpr size_t kLexerRing = 4 * ZITH_LEXER_LOOKAHEAD;
+static constexpr size_t kLexerChunk = 64 * 1024;
+
+static_assert((kLexerRing & (kLexerRing - 1)) == 0, "ring size must be a power of two");
+
+struct ZithLexer {
+    ZithLexerRead read = nullptr;
+    void *ctx = nullptr;
+    int fd = -1;
+    size_t chunk = kLexerChunk;
+
+    // Input window: buf[0, len) holds the bytes [base, base + len)
+    std::vector<char> buf;
+    size_t base = 0;
+    size_t len = 0;
+    size_t cursor = 0;        // where lexing resumes (always between tokens)
+    bool eof = false;
+    bool ended = false;       // END is in the ring
+    bool failed = false;
+
+    // Line of 'base' and the offset where it starts, for error reports
+    size_t base_line = 1;
+    size_t base_line_start = 0;
+
+    ZithToken ring[kLexerRing]{};
+    size_t head = 0;          // tokens handed out so far
+    size_t produced = 0;      // tokens lexed so far
+
+    ZithArena *scratch = nullptr;
+};
+
+namespace zith::detail {
+    static ZithToken &ring_at(ZithLexer *lx, const size_t i) {
+        return lx->ring[i & (kLexerRing - 1)];
+    }
+
+    // Lexemes are views into buf: re-point them after it moves
+    static void rebase_ring(ZithLexer *lx) {
+        const size_t oldest = lx->produced > kLexerRing ? lx->produced - kLexerRing : 0;
+        for (size_t i = oldest; i < lx->produced; ++i) {
+            ZithToken &t = ring_at(lx, i);
+            if (t.loc.offset >= lx->base) t.lexeme.data = lx->buf.data() + (t.loc.offset - lx->base);
+        }
+    }
+
+    static ZithLineCol stream_line_col(const ZithLexer *lx, const size_t offset) {
+        size_t line = lx->base_line;
+        size_t line_start = lx->base_line_start;
+        const char *p = lx->buf.data();
+        const char *stop = p + (offset - lx->base);
+        for (; (p = static_cast<const char *>(std::memchr(p, '\n', stop - p))); ++p) {
+            ++line;
+            line_start = lx->base + static_cast<size_t>(p + 1 - lx->buf.data());
+        }
+        return {line, offset - line_start + 1};
+    }
+
+    // Drops the bytes no live token refers to and reads one more chunk
+    static bool stream_refill(ZithLexer *lx) {
+        size_t keep = lx->cursor;
+        if (lx->produced > 0) {
+            const size_t oldest = lx->produced > kLexerRing ? lx->produced - kLexerRing : 0;
+            keep = std::min(keep, std::max(ring_at(lx, oldest).loc.offset, lx->base));
+        }
+
+        const size_t drop = keep - lx->base;
+        if (drop > 0) {
+            const char *p = lx->buf.data();
+            const char *stop = p + drop;
+            for (; (p = static_cast<const char *>(std::memchr(p, '\n', stop - p))); ++p) {
+                ++lx->base_line;
+                lx->base_line_start = lx->base + static_cast<size_t>(p + 1 - lx->buf.data());
+            }
+            std::memmove(lx->buf.data(), lx->buf.data() + drop, lx->len - drop);
+            lx->len -= drop;
+            lx->base = keep;
+        }
+
+        // A token longer than the window makes it grow
+        if (lx->buf.size() - lx->len < lx->chunk) lx->buf.resize(lx->len + lx->chunk);
+        rebase_ring(lx);
+
+        const ptrdiff_t n = lx->read(lx->ctx, lx->buf.data() + lx->len, lx->buf.size() - lx->len);
+        if (n < 0) {
+            std::cerr << "Read error while lexing (offset " << lx->base + lx->len << ")\n";
+            lx->failed = true;
+            return false;
+        }
+        if (n == 0) lx->eof = true;
+        lx->len += static_cast<size_t>(n);
+        return true;
+    }
+
+    // Lexes up to 'want' tokens from the window into the ring. Only tokens
+    // the unread input can no longer change are kept; returns false when
+    // none were and more input is needed
+    static bool stream_lex(ZithLexer *lx, const size_t want) {
+        zith_arena_reset(lx->scratch);
+
+        const char *begin = lx->buf.data();
+        const char *end = begin + lx->len;
+        TokenList fresh;
+        fresh.init(lx->scratch, want);
+        std::vector<LexError> error_list;
+        const char *stop = lex(begin, begin + (lx->cursor - lx->base), end, lx->scratch, fresh, nullptr, error_list,
+                               [&](const char *) { return fresh.size() >= want; });
+
+        // Before EOF, a token near the end of the window may still grow
+        size_t kept = 0;
+        size_t kept_end = lx->cursor - lx->base;
+        for (const ZithToken &t: fresh) {
+            const size_t t_end = t.loc.offset + t.lexeme.len;
+            if (!lx->eof && t_end + kLexLookahead > lx->len) break;
+            ++kept;
+            kept_end = t_end;
+        }
+        const bool all = kept == fresh.size();
+        if (all && (stop || lx->eof)) kept_end = stop ? static_cast<size_t>(stop - begin) : lx->len;
+
+        // Errors inside the kept part are final; past it they may be an
+        // unterminated string or comment that the next chunk closes
+        bool fatal = false;
+        for (const auto &err: error_list) {
+            if (lx->eof || err.info.offset < kept_end) {
+                const ZithLineCol lc = stream_line_col(lx, lx->base + err.info.offset);
+                std::cerr << "Lexical error (line " << lc.line
+                        << ", col " << lc.column << "): " << err.msg << '\n';
+                fatal = true;
+            }
+        }
+        if (fatal) {
+            lx->failed = true;
+            return true;
+        }
+
+        size_t i = 0;
+        for (const ZithToken &t: fresh) {
+            if (i++ == kept) break;
+            ZithToken &slot = ring_at(lx, lx->produced++);
+            slot = t;
+            slot.loc.offset += lx->base;
+        }
+        lx->cursor = lx->base + kept_end;
+
+        if (lx->eof && all && !stop) {
+            ring_at(lx, lx->produced++) = make_token(ZITH_TOKEN_END, std::string_view(end, 0),
+                                                     {lx->base + lx->len});
+            lx->ended = true;
+        }
+        return kept > 0 || lx->ended;
+    }
+
+    // Makes sure the ring holds 'n' tokens past head (fewer only at END)
+    static bool stream_fill(ZithLexer *lx, const size_t n) {
+        while (!lx->failed && !lx->ended && lx->produced - lx->head < n) {
+            if (lx->cursor - lx->base < lx->len || lx->eof) {
+                if (stream_lex(lx, n - (lx->produced - lx->head))) continue;
+            }
+            if (!lx->eof && !stream_refill(lx)) break;
+        }
+        return !lx->failed;
+    }
+
+    static ptrdiff_t fd_read(void *ctx, char *buf, const size_t cap) {
+        const int fd = *static_cast<const int *>(ctx);
+        for (;;) {
+#ifdef _WIN32
+            const int n = _read(fd, buf, static_cast<unsigned>(std::min<size_t>(cap, INT_MAX)));
+#else
+            const ssize_t n = ::read(fd, buf, cap);
+            if (n < 0 && errno == EINTR) continue;
+#endif
+            return static_cast<ptrdiff_t>(n);
+        }
+    }
+} // namespace zith::detail
+
+ZithLexer *zith_lexer_create(const ZithLexerRead read, void *ctx, const size_t chunk_size) {
+    if (!read) return nullptr;
+
+    auto *lx = new(std::nothrow) ZithLexer();
+    if (!lx) return nullptr;
+    lx->read = read;
+    lx->ctx = ctx;
+    lx->chunk = chunk_size ? chunk_size : kLexerChunk;
+    lx->scratch = zith_arena_create(0);
+    if (!lx->scratch) {
+        delete lx;
+        return nullptr;
+    }
+    return lx;
+}
+
+ZithLexer *zith_lexer_create_fd(const int fd, const size_t chunk_size) {
+    if (fd < 0) return nullptr;
+    ZithLexer *lx = zith_lexer_create(zith::detail::fd_read, nullptr, chunk_size);
+    if (!lx) return nullptr;
+    lx->fd = fd;
+    lx->ctx = &lx->fd;
+    return lx;
+}
+
+void zith_lexer_destroy(ZithLexer *lexer) {
+    if (!lexer) return;
+    zith_arena_destroy(lexer->scratch);
+    delete lexer;
+}
+
+const ZithToken *zith_lexer_peek(ZithLexer *lexer, const size_t n) {
+    if (!lexer || n >= ZITH_LEXER_LOOKAHEAD) return nullptr;
+    if (!zith::detail::stream_fill(lexer, n + 1)) return nullptr;
+
+    // Past END the answer is END
+    const size_t i = std::min(lexer->head + n, lexer->produced - 1);
+    return &zith::detail::ring_at(lexer, i);
+}
+
+const ZithToken *zith_lexer_next(ZithLexer *lexer) {
+    const ZithToken *tok = zith_lexer_peek(lexer, 0);
+    if (tok && tok->type != ZITH_TOKEN_END) ++lexer->head;
+    return tok;
+}
+
+bool zith_lexer_failed(const ZithLexer *lexer) {
+    return !lexer || lexer->failed;
+}
 
 // ============================================================================
 // Debug
@@ -598,10 +1067,13 @@ void zith_debug_tokens(ZithArena *arena, const char *source, const size_t source
 
     std::vector<zith::detail::LexError> error_list;
     zith::detail::TokenList tokens;
-    zith::detail::tokenize(std::string_view(source, source_len), arena, tokens, error_list);
+    zith::detail::tokenize(std::string_view(source, source_len), arena, tokens, nullptr, error_list);
 
     size_t count = 0;
-    ZithToken *flat = tokens.flatten(arena, &count);
+    ZithToken *flat = tokens.take_contiguous(arena, &count);
+
+    ZithLineIndex lines{};
+    zith_line_index_build(arena, source, source_len, &lines);
 
     // ── Header ───────────────────────────────────────────────────────────────
     std::cerr << "\n╔══════════════════════════════════════════════════════════╗\n";
@@ -632,13 +1104,14 @@ void zith_debug_tokens(ZithArena *arena, const char *source, const size_t source
             if (static_cast<unsigned char>(lexeme_buf[j]) < 0x20) lexeme_buf[j] = '?';
 
         const char *type_name = token_type_name(tok.type);
+        const ZithLineCol lc = zith_line_index_resolve(&lines, tok.loc.offset);
 
         std::cerr << "║ "
                 << i
                 << " \t║ "
-                << tok.loc.line
+                << lc.line
                 << " \t║ "
-                << tok.loc.index
+                << lc.column
                 << " \t║ "
                 << type_name
                 << " \t║ "
@@ -655,8 +1128,9 @@ void zith_debug_tokens(ZithArena *arena, const char *source, const size_t source
         std::cerr << "\n  Lexical errors (" << error_list.size() << "):\n";
         for (size_t i = 0; i < error_list.size(); ++i) {
             const auto &err = error_list[i];
-            std::cerr << "  [" << i << "] line " << err.info.line
-                    << ", col " << err.info.index
+            const ZithLineCol lc = zith_line_index_resolve(&lines, err.info.offset);
+            std::cerr << "  [" << i << "] line " << lc.line
+                    << ", col " << lc.column
                     << " → " << err.msg << "\n";
         }
     } else {
@@ -664,5 +1138,3 @@ void zith_debug_tokens(ZithArena *arena, const char *source, const size_t source
     }
     std::cerr << '\n';
 }
-
-#undef ZITH_NEWLINE
\ No newline at end of file
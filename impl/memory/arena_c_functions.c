@@ -1,20 +1,84 @@
 // src/arena.c
+#if !defined(_WIN32) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE  // MAP_ANONYMOUS / MAP_NORESERVE / madvise under -std=c11
+#endif
+
 #include <zith/zith.hpp>
+#include <stdatomic.h>
 #include <stddef.h>  // gives you max_align_t on MSVC
+#include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
 #define ZITH_DEFAULT_BLOCK_SIZE (64 * 1024)
 
+// Reserved (virtual memory) arenas: default reservation and commit steps
+#define ZITH_ARENA_VM_DEFAULT_RESERVE ((size_t) 1 << 30)
+#define ZITH_ARENA_VM_COMMIT_STEP ((size_t) 64 * 1024)
+#define ZITH_ARENA_VM_HUGE_PAGE ((size_t) 2 * 1024 * 1024)
+
+// Allocations bigger than block_size / ZITH_LARGE_ALLOC_DIVISOR bypass the
+// block chain and get a dedicated block, so one big buffer never strands the
+// tail of the current block.
+#define ZITH_LARGE_ALLOC_DIVISOR 4
+
+// Retired large blocks are kept per size class: class k holds blocks whose
+// capacity is exactly 2^k bytes.
+#define ZITH_ARENA_SIZE_CLASSES 48
+
+// Under AddressSanitizer, memory the arena has not handed out (fresh block
+// tails, rewound and reset ranges, retired blocks) is manually poisoned, so a
+// pointer that outlives its checkpoint faults at the access.
+#if defined(__SANITIZE_ADDRESS__)
+#define ZITH_ARENA_ASAN 1
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define ZITH_ARENA_ASAN 1
+#endif
+#endif
+
+#ifdef ZITH_ARENA_ASAN
+#include <sanitizer/asan_interface.h>
+#define ARENA_POISON(p, n) ASAN_POISON_MEMORY_REGION((p), (n))
+#define ARENA_UNPOISON(p, n) ASAN_UNPOISON_MEMORY_REGION((p), (n))
+#else
+#define ARENA_POISON(p, n) ((void) (p), (void) (n))
+#define ARENA_UNPOISON(p, n) ((void) (p), (void) (n))
+#endif
+
+// ZITH_ARENA_DEBUG: every allocation is followed by ZITH_ARENA_GUARD_SIZE
+// guard bytes, checked when the allocation is released (rewind, reset,
+// destroy) and by zith_arena_check; released memory is overwritten with a
+// poison pattern.
+#ifdef ZITH_ARENA_DEBUG
+#define ZITH_ARENA_GUARD_BYTE 0xFD
+#define ZITH_ARENA_FREED_BYTE 0xDD
+#endif
+
+#if defined(ZITH_ARENA_DEBUG) || defined(ZITH_ARENA_ASAN)
+#define ZITH_ARENA_CHECKED 1
+#endif
+
 #ifdef _MSC_VER
   #pragma warning(push)
   #pragma warning(disable: 4200)
 #endif
 
+// 'capacity' is the usable size of data[]. For the block of a reserved arena it
+// is the committed part, and 'reserve' is the size of the whole mapping;
+// heap blocks have reserve == 0.
 typedef struct ZithArenaBlock {
     struct ZithArenaBlock *next;
     size_t offset;
     size_t capacity;
+    size_t reserve;
     char data[];
 } ZithArenaBlock;
 
@@ -22,15 +86,166 @@ typedef struct ZithArenaBlock {
   #pragma warning(pop)
 #endif
 
+// Deferred release of something the arena's memory refers to (e.g. a mapped
+// source file). Lives in the arena itself, newest first.
+typedef struct ZithArenaCleanup {
+    struct ZithArenaCleanup *next;
+    void (*fn)(void *ctx);
+    void *ctx;
+} ZithArenaCleanup;
+
+// Chain blocks shared between the arenas of a pool, as a Treiber stack.
+// Pushes CAS a list onto the head and never wait. Pops take 'pop_lock' for
+// the few instructions of their CAS: with one popper at a time the head seen
+// can only change by a push, never be popped and pushed back, so there is no
+// ABA. Pool blocks are only freed by zith_arena_pool_destroy.
+struct ZithArenaPool {
+    _Atomic(ZithArenaBlock *) free_head;
+    atomic_flag pop_lock;
+    atomic_size_t free_count;
+    size_t block_size;
+};
+
+// Standard blocks form a chain in allocation order. 'current' is the block
+// being bumped; everything after it was recycled by a reset and is reused in
+// order before any new block is malloc'd. Pooled arenas draw chain blocks from
+// their pool and give them back on reset instead.
 struct ZithArena {
-    ZithArenaBlock *head;
+    ZithArenaBlock *first;
+    ZithArenaBlock *current;
+    ZithArenaBlock *large;                                // live, newest first
+    ZithArenaBlock *large_free[ZITH_ARENA_SIZE_CLASSES];  // retired, by class
     size_t initial_block_size;
+    ZithArenaStats stats;
+    ZithArenaTag tag;
+    ZithArenaPool *pool;
+    size_t vm_step;  // commit granularity of a reserved arena
+    char **guards;   // ZITH_ARENA_DEBUG: guard of each live allocation, in order
+    size_t guard_count;
+    size_t guard_capacity;
+    ZithArenaCleanup *cleanups;
 };
 
 static inline size_t align_up(const size_t size, const size_t alignment) {
     return (size + alignment - 1) & ~(alignment - 1);
 }
 
+// Smallest k such that 2^k >= size
+static inline size_t size_class(const size_t size) {
+    size_t k = 0;
+    while (k < ZITH_ARENA_SIZE_CLASSES && ((size_t) 1 << k) < size) ++k;
+    return k;
+}
+
+// ============================================================================
+// Virtual memory
+// ============================================================================
+
+static void *vm_reserve(const size_t bytes, const size_t align) {
+#if defined(_WIN32)
+    (void) align;
+    return VirtualAlloc(NULL, bytes, MEM_RESERVE, PAGE_NOACCESS);
+#else
+#ifndef MAP_NORESERVE
+#define MAP_NORESERVE 0
+#endif
+    // Over-reserve to place the mapping on an 'align' boundary (huge pages)
+    const size_t span = bytes + (align > ZITH_ARENA_VM_COMMIT_STEP ? align : 0);
+    char *p = mmap(NULL, span, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (p == MAP_FAILED) return NULL;
+    if (span == bytes) return p;
+
+    char *aligned = (char *) align_up((size_t) p, align);
+    if (aligned > p) munmap(p, (size_t) (aligned - p));
+    const size_t tail = (size_t) ((p + span) - (aligned + bytes));
+    if (tail) munmap(aligned + bytes, tail);
+    return aligned;
+#endif
+}
+
+static int vm_commit(void *addr, const size_t bytes) {
+#if defined(_WIN32)
+    return VirtualAlloc(addr, bytes, MEM_COMMIT, PAGE_READWRITE) != NULL;
+#else
+    return mprotect(addr, bytes, PROT_READ | PROT_WRITE) == 0;
+#endif
+}
+
+static void vm_decommit(void *addr, const size_t bytes) {
+#if defined(_WIN32)
+    VirtualFree(addr, bytes, MEM_DECOMMIT);
+#else
+    madvise(addr, bytes, MADV_DONTNEED);
+    mprotect(addr, bytes, PROT_NONE);
+#endif
+}
+
+static void vm_release(void *addr, const size_t bytes) {
+#if defined(_WIN32)
+    (void) bytes;
+    VirtualFree(addr, 0, MEM_RELEASE);
+#else
+    munmap(addr, bytes);
+#endif
+}
+
+static void free_block(ZithArenaBlock *block) {
+    // Leave no stale shadow behind for whatever reuses the address range
+    if (block->reserve) {
+        ARENA_UNPOISON(block, block->reserve);
+        vm_release(block, block->reserve);
+    } else {
+        ARENA_UNPOISON(block->data, block->capacity);
+        free(block);
+    }
+}
+
+// Commits enough of a reserved block for the allocation, doubling the
+// committed size so a growing arena makes O(log n) commit calls
+static int vm_grow(ZithArena *arena, ZithArenaBlock *block, const size_t size, const size_t align) {
+    const uintptr_t base = (uintptr_t) block->data;
+    const size_t need = sizeof(ZithArenaBlock) +
+                        (size_t) (align_up(base + block->offset, align) - base) + size;
+    const size_t committed = sizeof(ZithArenaBlock) + block->capacity;
+
+    size_t want = align_up(need > committed * 2 ? need : committed * 2, arena->vm_step);
+    if (want > block->reserve) want = align_up(need, arena->vm_step);
+    if (want > block->reserve) return 0;
+
+    if (!vm_commit((char *) block + committed, want - committed)) return 0;
+    ARENA_POISON((char *) block + committed, want - committed);
+    block->capacity = want - sizeof(ZithArenaBlock);
+    arena->stats.reserved += want - committed;
+    return 1;
+}
+
+// ============================================================================
+// Blocks
+// ============================================================================
+
+static void pool_push(ZithArenaPool *pool, ZithArenaBlock *head, ZithArenaBlock *tail, const size_t n) {
+    ZithArenaBlock *old = atomic_load_explicit(&pool->free_head, memory_order_relaxed);
+    do {
+        tail->next = old;
+    } while (!atomic_compare_exchange_weak_explicit(&pool->free_head, &old, head,
+                                                    memory_order_release, memory_order_relaxed));
+    atomic_fetch_add_explicit(&pool->free_count, n, memory_order_relaxed);
+}
+
+// O(1): other poppers wait out one CAS instead of finding the pool empty
+static ZithArenaBlock *pool_pop(ZithArenaPool *pool) {
+    if (!atomic_load_explicit(&pool->free_head, memory_order_relaxed)) return NULL;
+    while (atomic_flag_test_and_set_explicit(&pool->pop_lock, memory_order_acquire)) {}
+
+    ZithArenaBlock *head = atomic_load_explicit(&pool->free_head, memory_order_acquire);
+    while (head && !atomic_compare_exchange_weak_explicit(&pool->free_head, &head, head->next,
+                                                          memory_order_acquire, memory_order_acquire)) {}
+
+    atomic_flag_clear_explicit(&pool->pop_lock, memory_order_release);
+    if (head) atomic_fetch_sub_explicit(&pool->free_count, 1, memory_order_relaxed);
+    return head;
+}
+
 struct ZithArena *zith_arena_create(size_t initial_block_size) {
     if (initial_block_size == 0) initial_block_size = ZITH_DEFAULT_BLOCK_SIZE;
     struct ZithArena *arena = calloc(1, sizeof(ZithArena));
@@ -39,59 +254,586 @@ struct ZithArena *zith_arena_create(size_t initial_block_size) {
     return arena;
 }
 
-void *zith_arena_alloc(ZithArena *arena, size_t size) {
-    if (!arena || size == 0) return NULL;
+ZithArena *zith_arena_create_reserved(size_t reserve_bytes, const unsigned flags) {
+    ZithArena *arena = zith_arena_create(0);
+    if (!arena) return NULL;
+
+    const size_t step = (flags & ZITH_ARENA_HUGE_PAGES) ? ZITH_ARENA_VM_HUGE_PAGE : ZITH_ARENA_VM_COMMIT_STEP;
+    if (reserve_bytes == 0) reserve_bytes = ZITH_ARENA_VM_DEFAULT_RESERVE;
+    reserve_bytes = align_up(reserve_bytes, step);
+
+    // Without a reservation this simply stays a heap arena
+    char *base = vm_reserve(reserve_bytes, step);
+    if (!base) return arena;
+#if defined(MADV_HUGEPAGE)
+    if (flags & ZITH_ARENA_HUGE_PAGES) madvise(base, reserve_bytes, MADV_HUGEPAGE);
+#endif
+    if (!vm_commit(base, step)) {
+        vm_release(base, reserve_bytes);
+        return arena;
+    }
+
+    ZithArenaBlock *block = (ZithArenaBlock *) base;
+    block->next = NULL;
+    block->offset = 0;
+    block->capacity = step - sizeof(ZithArenaBlock);
+    block->reserve = reserve_bytes;
+    ARENA_POISON(block->data, block->capacity);
+
+    arena->first = arena->current = block;
+    arena->vm_step = step;
+    arena->stats.blocks = 1;
+    arena->stats.reserved = step;
+    return arena;
+}
+
+bool zith_arena_is_reserved(const ZithArena *arena) {
+    return arena && arena->first && arena->first->reserve;
+}
+
+// Advances to the next recycled block, or appends a fresh one to the chain
+static ZithArenaBlock *next_block(ZithArena *arena) {
+    ZithArenaBlock *cur = arena->current;
+    if (cur && cur->next) {
+        cur->next->offset = 0;
+        arena->current = cur->next;
+        return arena->current;
+    }
+
+    const size_t block_size = arena->initial_block_size;
+    ZithArenaBlock *block = arena->pool ? pool_pop(arena->pool) : NULL;
+    if (!block) {
+        block = (ZithArenaBlock *) malloc(sizeof(ZithArenaBlock) + block_size);
+        if (!block) return NULL;
+        block->capacity = block_size;
+        block->reserve = 0;
+    }
+    arena->stats.blocks++;
+    arena->stats.reserved += sizeof(ZithArenaBlock) + block->capacity;
+
+    block->next = NULL;
+    block->offset = 0;
+    ARENA_POISON(block->data, block->capacity);
+    if (cur) cur->next = block;
+    else arena->first = block;
+    arena->current = block;
+    return block;
+}
+
+// Bumps 'block' to the next 'align' boundary of its actual address, or
+// returns NULL if the allocation does not fit
+static void *bump(ZithArenaBlock *block, const size_t size, const size_t align) {
+    const uintptr_t base = (uintptr_t) block->data;
+    const uintptr_t at = (uintptr_t) align_up(base + block->offset, align);
+    if (at + size > base + block->capacity) return NULL;
+    block->offset = (size_t) (at + size - base);
+    ARENA_UNPOISON((void *) at, size);
+    return (void *) at;
+}
+
+static void *alloc_large(ZithArena *arena, const size_t size, const size_t align) {
+    // Slack for aligning inside the block — the header leaves data[] at
+    // pointer alignment only
+    const size_t need = size + align - 1;
+    const size_t cls = size_class(need);
+    ZithArenaBlock *block = NULL;
+
+    if (cls < ZITH_ARENA_SIZE_CLASSES && arena->large_free[cls]) {
+        block = arena->large_free[cls];
+        arena->large_free[cls] = block->next;
+    } else {
+        const size_t capacity = cls < ZITH_ARENA_SIZE_CLASSES ? (size_t) 1 << cls : need;
+        block = (ZithArenaBlock *) malloc(sizeof(ZithArenaBlock) + capacity);
+        if (!block) return NULL;
+        block->capacity = capacity;
+        block->reserve = 0;
+        arena->stats.reserved += sizeof(ZithArenaBlock) + capacity;
+        ARENA_POISON(block->data, capacity);
+    }
+
+    block->offset = 0;
+    block->next = arena->large;
+    arena->large = block;
+    return bump(block, size, align);
+}
+
+// Gives a list of chain blocks back to the pool, or to the system
+static void release_chain(ZithArena *arena, ZithArenaBlock *head) {
+    if (!head) return;
+
+    ZithArenaBlock *tail = head;
+    size_t n = 0;
+    for (ZithArenaBlock *b = head; b; b = b->next) {
+        arena->stats.reserved -= sizeof(ZithArenaBlock) + b->capacity;
+        tail = b;
+        ++n;
+    }
+    arena->stats.blocks -= n;
+
+    if (arena->pool) {
+        pool_push(arena->pool, head, tail, n);
+        return;
+    }
+    while (head) {
+        ZithArenaBlock *next = head->next;
+        free_block(head);
+        head = next;
+    }
+}
+
+static void free_large_lists(ZithArena *arena) {
+    for (size_t cls = 0; cls < ZITH_ARENA_SIZE_CLASSES; ++cls) {
+        while (arena->large_free[cls]) {
+            ZithArenaBlock *next = arena->large_free[cls]->next;
+            arena->stats.reserved -= sizeof(ZithArenaBlock) + arena->large_free[cls]->capacity;
+            free_block(arena->large_free[cls]);
+            arena->large_free[cls] = next;
+        }
+    }
+}
+
+// ============================================================================
+// Debug checks
+// ============================================================================
+
+// Marks [p, p + n) as no longer handed out
+static void release_range(char *p, const size_t n) {
+#ifdef ZITH_ARENA_DEBUG
+    ARENA_UNPOISON(p, n);
+    memset(p, ZITH_ARENA_FREED_BYTE, n);
+#endif
+    ARENA_POISON(p, n);
+}
+
+// Releases the chain from (block, offset) up to the current bump pointer.
+// Walks the blocks in between, so checked builds only.
+static void release_chain_tail(ZithArena *arena, ZithArenaBlock *block, size_t offset) {
+#ifdef ZITH_ARENA_CHECKED
+    if (!block) {
+        block = arena->first;
+        offset = 0;
+    }
+    for (; block; block = block->next) {
+        if (block->offset > offset) release_range(block->data + offset, block->offset - offset);
+        if (block == arena->current) break;
+        offset = 0;
+    }
+#else
+    (void) arena;
+    (void) block;
+    (void) offset;
+#endif
+}
+
+#ifdef ZITH_ARENA_DEBUG
+static void guard_place(char *at) {
+    ARENA_UNPOISON(at, ZITH_ARENA_GUARD_SIZE);
+    memset(at, ZITH_ARENA_GUARD_BYTE, ZITH_ARENA_GUARD_SIZE);
+    ARENA_POISON(at, ZITH_ARENA_GUARD_SIZE);
+}
+
+static int guard_intact(char *at) {
+    ARENA_UNPOISON(at, ZITH_ARENA_GUARD_SIZE);
+    int ok = 1;
+    for (size_t i = 0; i < ZITH_ARENA_GUARD_SIZE; ++i)
+        if ((unsigned char) at[i] != ZITH_ARENA_GUARD_BYTE) ok = 0;
+    ARENA_POISON(at, ZITH_ARENA_GUARD_SIZE);
+    return ok;
+}
+
+static void guard_push(ZithArena *arena, char *at) {
+    guard_place(at);
+    if (arena->guard_count == arena->guard_capacity) {
+        const size_t cap = arena->guard_capacity ? arena->guard_capacity * 2 : 256;
+        char **grown = realloc(arena->guards, cap * sizeof(char *));
+        if (!grown) return;  // this allocation just goes unchecked
+        arena->guards = grown;
+        arena->guard_capacity = cap;
+    }
+    arena->guards[arena->guard_count++] = at;
+}
+#endif
+
+static size_t count_broken_guards(const ZithArena *arena, const size_t from) {
+    size_t broken = 0;
+#ifdef ZITH_ARENA_DEBUG
+    for (size_t i = from; i < arena->guard_count; ++i) {
+        if (!guard_intact(arena->guards[i])) {
+            fprintf(stderr, "zith arena: write past the end of allocation ending at %p\n",
+                    (void *) arena->guards[i]);
+            ++broken;
+        }
+    }
+#else
+    (void) arena;
+    (void) from;
+#endif
+    return broken;
+}
 
-    const size_t alignment = _Alignof(max_align_t);
-    size = align_up(size, alignment);
+// Checks and drops the guards of allocations being released; a broken
+// guard means heap corruption, so stop right there
+static void drop_guards(ZithArena *arena, const size_t from) {
+    if (count_broken_guards(arena, from)) abort();
+    arena->guard_count = from;
+}
 
-    ZithArenaBlock *block = arena->head;
-    if (!block || block->offset + size > block->capacity) {
-        // Allocate new block
-        size_t block_size = arena->initial_block_size;
-        if (size > block_size) block_size = size; // accommodate large allocs
+// Runs deferred cleanups registered after 'stop', newest first
+static void run_cleanups(ZithArena *arena, const ZithArenaCleanup *stop) {
+    while (arena->cleanups && arena->cleanups != stop) {
+        ZithArenaCleanup *c = arena->cleanups;
+        arena->cleanups = c->next;
+        c->fn(c->ctx);
+    }
+}
 
-        const size_t total_alloc = sizeof(ZithArenaBlock) + block_size;
-        ZithArenaBlock *new_block = (ZithArenaBlock *) malloc(total_alloc);
-        if (!new_block) return NULL;
+// Moves live large blocks onto their size-class free lists until 'stop'
+static void retire_large(ZithArena *arena, const ZithArenaBlock *stop) {
+    while (arena->large && arena->large != stop) {
+        ZithArenaBlock *block = arena->large;
+        arena->large = block->next;
+        release_range(block->data, block->offset);
 
-        new_block->next = arena->head;
-        new_block->offset = 0;
-        new_block->capacity = block_size;
-        arena->head = new_block;
-        block = new_block;
+        const size_t cls = size_class(block->capacity);
+        if (!block->reserve && cls < ZITH_ARENA_SIZE_CLASSES && ((size_t) 1 << cls) == block->capacity) {
+            block->next = arena->large_free[cls];
+            arena->large_free[cls] = block;
+        } else {
+            arena->stats.reserved -= sizeof(ZithArenaBlock) + block->capacity;
+            free_block(block);
+        }
     }
+}
+
+// 'consumed' is what the bump pointer advanced: size plus alignment padding
+static void record(ZithArena *arena, const size_t size, const size_t consumed) {
+    ZithArenaStats *s = &arena->stats;
+    s->requested += size;
+    s->padded += consumed - size;
+    s->used += consumed;
+    if (s->used > s->peak) s->peak = s->used;
+#ifdef ZITH_ARENA_PROFILE
+    s->by_tag[arena->tag] += size;
+#endif
+}
 
-    void *ptr = &block->data[block->offset];
-    block->offset += size;
+static void *alloc_large_counted(ZithArena *arena, const size_t size, const size_t align) {
+    void *ptr = alloc_large(arena, size + ZITH_ARENA_GUARD_SIZE, align);
+    if (!ptr) return NULL;
+    arena->stats.large_allocs++;
+    record(arena, size, arena->large->offset);
     return ptr;
 }
 
+static void *alloc_bytes(ZithArena *arena, const size_t size, const size_t align) {
+    const size_t span = size + ZITH_ARENA_GUARD_SIZE;
+    ZithArenaBlock *block = arena->current;
+    const bool reserved = block && block->reserve;
+    const bool large = size > arena->initial_block_size / ZITH_LARGE_ALLOC_DIVISOR;
+
+    // A reserved block has no tail to strand: large requests stay inline
+    if (large && !reserved) return alloc_large_counted(arena, size, align);
+
+    size_t before = block ? block->offset : 0;
+    void *ptr = block ? bump(block, span, align) : NULL;
+    if (!ptr && reserved && vm_grow(arena, block, span, align))
+        ptr = bump(block, span, align);
+    if (!ptr) {
+        // Reservation exhausted: continue on heap blocks
+        if (large) return alloc_large_counted(arena, size, align);
+        block = next_block(arena);
+        if (!block) return NULL;
+        before = 0;
+        ptr = bump(block, span, align);
+        if (!ptr) return NULL;
+    }
+
+    record(arena, size, block->offset - before);
+    return ptr;
+}
+
+void *zith_arena_alloc_aligned(ZithArena *arena, const size_t size, const size_t align) {
+    if (!arena || size == 0) return NULL;
+    if (align == 0 || (align & (align - 1)) != 0) return NULL;
+
+    char *ptr = alloc_bytes(arena, size, align);
+#ifdef ZITH_ARENA_DEBUG
+    if (ptr) guard_push(arena, ptr + size);
+#endif
+    return ptr;
+}
+
+bool zith_arena_try_extend(ZithArena *arena, void *ptr, const size_t old_size, const size_t new_size) {
+    if (!arena || !ptr) return false;
+
+    ZithArenaBlock *candidates[2] = {arena->current, arena->large};
+    for (int i = 0; i < 2; ++i) {
+        ZithArenaBlock *block = candidates[i];
+        if (!block) continue;
+        char *p = (char *) ptr;
+        if (p < block->data || p + old_size + ZITH_ARENA_GUARD_SIZE != block->data + block->offset) continue;
+
+        const size_t start = (size_t) (p - block->data);
+        if (start + new_size + ZITH_ARENA_GUARD_SIZE > block->capacity &&
+            !(block->reserve && vm_grow(arena, block, new_size - old_size, 1)))
+            return false;
+
+        block->offset = start + new_size + ZITH_ARENA_GUARD_SIZE;
+        if (new_size >= old_size) {
+            ARENA_UNPOISON(p + old_size, new_size - old_size);
+            record(arena, new_size - old_size, new_size - old_size);
+        } else {
+            release_range(p + new_size, old_size - new_size);
+            arena->stats.used -= old_size - new_size;
+        }
+#ifdef ZITH_ARENA_DEBUG
+        // The guard moves with the end of the allocation
+        for (size_t g = arena->guard_count; g-- > 0;) {
+            if (arena->guards[g] == p + old_size) {
+                arena->guards[g] = p + new_size;
+                guard_place(p + new_size);
+                break;
+            }
+        }
+#endif
+        return true;
+    }
+    return false;
+}
+
+bool zith_arena_defer(ZithArena *arena, void (*fn)(void *ctx), void *ctx) {
+    if (!arena || !fn) return false;
+    ZithArenaCleanup *c = zith_arena_alloc_aligned(arena, sizeof(ZithArenaCleanup), _Alignof(ZithArenaCleanup));
+    if (!c) return false;
+    c->fn = fn;
+    c->ctx = ctx;
+    c->next = arena->cleanups;
+    arena->cleanups = c;
+    return true;
+}
+
+void *zith_arena_alloc(ZithArena *arena, const size_t size) {
+    return zith_arena_alloc_aligned(arena, size, _Alignof(max_align_t));
+}
+
 char *zith_arena_strdup(ZithArena *arena, const char *str) {
     if (!str) return NULL;
     const size_t len = strlen(str);
-    void *copy = zith_arena_alloc(arena, len + 1);
+    void *copy = zith_arena_alloc_aligned(arena, len + 1, 1);
     if (copy) memcpy(copy, str, len + 1);
     return copy;
 }
 
 char *zith_arena_str(ZithArena *arena, const char *str, const size_t len) {
     if (!str) return NULL;
-    char *copy = zith_arena_alloc(arena, len + 1);
+    char *copy = zith_arena_alloc_aligned(arena, len + 1, 1);
     if (!copy) return NULL;
     memcpy(copy, str, len);
     copy[len] = '\0';
     return copy;
 }
 
+ZithArenaMark zith_arena_mark(const ZithArena *arena) {
+    ZithArenaMark mark = {NULL, 0, NULL, 0, 0, NULL};
+    if (!arena) return mark;
+    mark.block = arena->current;
+    mark.offset = arena->current ? arena->current->offset : 0;
+    mark.large = arena->large;
+    mark.used = arena->stats.used;
+    mark.guards = arena->guard_count;
+    mark.cleanups = arena->cleanups;
+    return mark;
+}
+
+// O(1) for the block chain, like reset: blocks past the mark stay linked and
+// are recycled in order. Large blocks allocated since the mark are retired.
+void zith_arena_rewind(ZithArena *arena, const ZithArenaMark mark) {
+    if (!arena) return;
+
+    ZithArenaBlock *block = (ZithArenaBlock *) mark.block;
+    run_cleanups(arena, (const ZithArenaCleanup *) mark.cleanups);
+    drop_guards(arena, mark.guards);
+    release_chain_tail(arena, block, mark.offset);
+    if (block) {
+        arena->current = block;
+        block->offset = mark.offset;
+    } else {
+        arena->current = arena->first;
+        if (arena->first) arena->first->offset = 0;
+    }
+    retire_large(arena, (const ZithArenaBlock *) mark.large);
+    arena->stats.used = mark.used;
+}
+
+// O(1) for the block chain: offsets of recycled blocks are cleared lazily
+// when allocation reaches them again. Pooled arenas keep their first block
+// and return the rest to the pool.
 void zith_arena_reset(ZithArena *arena) {
     if (!arena) return;
-    for (ZithArenaBlock *b = arena->head; b; b = b->next)
-        b->offset = 0;
+    run_cleanups(arena, NULL);
+    drop_guards(arena, 0);
+    release_chain_tail(arena, NULL, 0);
+    arena->current = arena->first;
+    if (arena->first) {
+        arena->first->offset = 0;
+        if (arena->pool) {
+            release_chain(arena, arena->first->next);
+            arena->first->next = NULL;
+        }
+    }
+    retire_large(arena, NULL);
+    arena->stats.used = 0;
+}
+
+void zith_arena_trim(ZithArena *arena) {
+    if (!arena) return;
+
+    if (arena->current) {
+        release_chain(arena, arena->current->next);
+        arena->current->next = NULL;
+    }
+    free_large_lists(arena);
+
+    // Reserved block in use: decommit the pages past the bump pointer
+    ZithArenaBlock *block = arena->current;
+    if (block && block->reserve) {
+        const size_t committed = sizeof(ZithArenaBlock) + block->capacity;
+        size_t keep = align_up(sizeof(ZithArenaBlock) + block->offset, arena->vm_step);
+        if (keep < arena->vm_step) keep = arena->vm_step;
+        if (keep < committed) {
+            vm_decommit((char *) block + keep, committed - keep);
+            block->capacity = keep - sizeof(ZithArenaBlock);
+            arena->stats.reserved -= committed - keep;
+        }
+    }
+}
+
+void zith_arena_adopt(ZithArena *dst, ZithArena *src) {
+    if (!dst || !src || dst == src) return;
+
+    // Spare blocks carry nothing; the rest is live and joins dst as
+    // dedicated blocks, retired by dst's next reset like its own large blocks
+    zith_arena_trim(src);
+
+    size_t moved = 0;
+    ZithArenaBlock *lists[2] = {src->first, src->large};
+    for (int i = 0; i < 2; ++i) {
+        ZithArenaBlock *b = lists[i];
+        while (b) {
+            ZithArenaBlock *next = b->next;
+            moved += sizeof(ZithArenaBlock) + b->capacity;
+            b->next = dst->large;
+            dst->large = b;
+            b = next;
+        }
+    }
+
+    // src's pending cleanups now run with dst's
+    if (src->cleanups) {
+        ZithArenaCleanup *tail = src->cleanups;
+        while (tail->next) tail = tail->next;
+        tail->next = dst->cleanups;
+        dst->cleanups = src->cleanups;
+        src->cleanups = NULL;
+    }
+
+#ifdef ZITH_ARENA_DEBUG
+    for (size_t i = 0; i < src->guard_count; ++i) guard_push(dst, src->guards[i]);
+    src->guard_count = 0;
+#endif
+
+    dst->stats.reserved += moved;
+    dst->stats.used += src->stats.used;
+    if (dst->stats.used > dst->stats.peak) dst->stats.peak = dst->stats.used;
+
+    src->first = src->current = src->large = NULL;
+    src->stats.used = 0;
+    src->stats.blocks = 0;
+    src->stats.reserved = 0;
 }
 
+size_t zith_arena_used(const ZithArena *arena) {
+    return arena ? arena->stats.used : 0;
+}
+
+void zith_arena_get_stats(const ZithArena *arena, ZithArenaStats *out) {
+    if (!out) return;
+    if (!arena) {
+        memset(out, 0, sizeof(*out));
+        return;
+    }
+    *out = arena->stats;
+}
+
+ZithArenaTag zith_arena_set_tag(ZithArena *arena, const ZithArenaTag tag) {
+    if (!arena) return ZITH_ARENA_TAG_OTHER;
+    const ZithArenaTag prev = arena->tag;
+    if ((unsigned) tag < ZITH_ARENA_TAG_COUNT) arena->tag = tag;
+    return prev;
+}
+
+const char *zith_arena_tag_name(const ZithArenaTag tag) {
+    switch (tag) {
+        case ZITH_ARENA_TAG_OTHER: return "other";
+        case ZITH_ARENA_TAG_TOKENS: return "tokens";
+        case ZITH_ARENA_TAG_AST_NODES: return "ast nodes";
+        case ZITH_ARENA_TAG_AST_PAYLOADS: return "ast payloads";
+        case ZITH_ARENA_TAG_DIAGNOSTICS: return "diagnostics";
+        case ZITH_ARENA_TAG_IMPORTS: return "imports";
+        default: return "?";
+    }
+}
+
+size_t zith_arena_check(const ZithArena *arena) {
+    return arena ? count_broken_guards(arena, 0) : 0;
+}
+
+// Every block goes back to the system, or to the pool for pooled arenas
 void zith_arena_destroy(ZithArena *arena) {
     if (!arena) return;
-    zith_arena_reset(arena);
+    run_cleanups(arena, NULL);
+    drop_guards(arena, 0);
+    release_chain_tail(arena, NULL, 0);
+    retire_large(arena, NULL);
+    free_large_lists(arena);
+    release_chain(arena, arena->first);
+    free(arena->guards);
     free(arena);
 }
+
+// ============================================================================
+// Pool
+// ============================================================================
+
+ZithArenaPool *zith_arena_pool_create(size_t block_size) {
+    if (block_size == 0) block_size = ZITH_DEFAULT_BLOCK_SIZE;
+    ZithArenaPool *pool = malloc(sizeof(ZithArenaPool));
+    if (!pool) return NULL;
+    atomic_init(&pool->free_head, NULL);
+    atomic_flag_clear(&pool->pop_lock);
+    atomic_init(&pool->free_count, 0);
+    pool->block_size = block_size;
+    return pool;
+}
+
+void zith_arena_pool_destroy(ZithArenaPool *pool) {
+    if (!pool) return;
+    ZithArenaBlock *b = atomic_exchange(&pool->free_head, NULL);
+    while (b) {
+        ZithArenaBlock *next = b->next;
+        free_block(b);
+        b = next;
+    }
+    free(pool);
+}
+
+ZithArena *zith_arena_pool_acquire(ZithArenaPool *pool) {
+    if (!pool) return NULL;
+    ZithArena *arena = zith_arena_create(pool->block_size);
+    if (arena) arena->pool = pool;
+    return arena;
+}
+
+size_t zith_arena_pool_cached(const ZithArenaPool *pool) {
+    return pool ? atomic_load_explicit(&((ZithArenaPool *) pool)->free_count, memory_order_relaxed) : 0;
+}
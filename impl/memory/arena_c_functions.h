@@ -7,10 +7,27 @@ extern "C" {
 #endif
 
 ZithArena *zith_arena_create(size_t initial_block_size);
+ZithArena *zith_arena_create_reserved(size_t reserve_bytes, unsigned flags);
+bool zith_arena_is_reserved(const ZithArena *arena);
 void zith_arena_destroy(ZithArena *arena);
+size_t zith_arena_check(const ZithArena *arena);
 void *zith_arena_alloc(ZithArena *arena, size_t size);
+void *zith_arena_alloc_aligned(ZithArena *arena, size_t size, size_t align);
+bool zith_arena_try_extend(ZithArena *arena, void *ptr, size_t old_size, size_t new_size);
 void zith_arena_reset(ZithArena *arena);
+void zith_arena_trim(ZithArena *arena);
+ZithArenaMark zith_arena_mark(const ZithArena *arena);
+void zith_arena_rewind(ZithArena *arena, ZithArenaMark mark);
+bool zith_arena_defer(ZithArena *arena, void (*fn)(void *ctx), void *ctx);
 size_t zith_arena_used(const ZithArena *arena);
+void zith_arena_get_stats(const ZithArena *arena, ZithArenaStats *out);
+ZithArenaTag zith_arena_set_tag(ZithArena *arena, ZithArenaTag tag);
+void zith_arena_adopt(ZithArena *dst, ZithArena *src);
+
+ZithArenaPool *zith_arena_pool_create(size_t block_size);
+void zith_arena_pool_destroy(ZithArenaPool *pool);
+ZithArena *zith_arena_pool_acquire(ZithArenaPool *pool);
+size_t zith_arena_pool_cached(const ZithArenaPool *pool);
 
 #ifdef __cplusplus
 }
@@ -1,4 +1,8 @@
 // src/utils/file.c
+#if !defined(_WIN32) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE  // MAP_ANONYMOUS / madvise under -std=c11
+#endif
+
 #include <zith/zith.hpp>
 #include <stdio.h>
 #include <stdlib.h>
@@ -18,6 +22,7 @@
 #define access _access
 #define F_OK 0
 #else
+#include <sys/mman.h>
 #include <unistd.h>
 #endif
 #ifdef _MSC_VER
@@ -53,9 +58,8 @@ bool zith_file_is_regular(const char *path) {
 }
 
 size_t zith_file_size(const char *path) {
-    if (!is_regular_file(path)) return 0;
     struct stat st;
-    if (stat(path, &st) != 0) return 0;
+    if (stat(path, &st) != 0 || !S_ISREG(st.st_mode)) return 0;
     return (size_t) st.st_size;
 }
 
@@ -82,72 +86,148 @@ bool zith_is_source_file(const char *path) {
     return zith_extension_matches(path, ZITH_SOURCE_EXT);
 }
 
-// Carrega um ficheiro fonte (.zith) para a arena.
-// Falha com erro descritivo se a extensão não for .zith,
-// o ficheiro não existir, não for regular, ou a leitura falhar.
-char *zith_load_file_to_arena(struct ZithArena *arena,
-                                  const char *path, size_t *out_size) {
-    if (!arena || !path || !out_size) {
-        if (out_size) *out_size = 0;
-        return NULL;
-    }
-
+// Valida a extensão e abre o ficheiro; um só fstat dá o tipo e o tamanho.
+// Reporta o erro e devolve NULL em caso de falha.
+static FILE *open_source(const char *path, size_t *out_size) {
     // Verificação de extensão — rejeita antes de abrir o ficheiro
     if (!zith_is_source_file(path)) {
         zith_io_error("'%s' is not a Zith source file (expected '%s')",
                 path, ZITH_SOURCE_EXT);
-        *out_size = 0;
-        return NULL;
-    }
-
-    if (!is_regular_file(path)) {
-        zith_io_error("'%s' is not a regular file", path);
-        *out_size = 0;
         return NULL;
     }
 
     FILE *f = fopen(path, "rb");
     if (!f) {
         zith_io_error("Failed to open '%s'", path);
-        *out_size = 0;
         return NULL;
     }
 
-    if (fseek(f, 0, SEEK_END) != 0) goto error;
-    const long size = ftell(f);
-    if (size < 0) goto error;
-    if (fseek(f, 0, SEEK_SET) != 0) goto error;
-
-    // Ficheiro vazio — válido, retorna buffer com '\0'
-    if (size == 0) {
+    struct stat st;
+    if (fstat(fileno(f), &st) != 0 || !S_ISREG(st.st_mode)) {
+        zith_io_error("'%s' is not a regular file", path);
         fclose(f);
-        *out_size = 0;
-        char *empty = zith_arena_alloc(arena, 1);
-        if (empty) empty[0] = '\0';
-        return empty;
+        return NULL;
     }
 
-    {
-        char *buffer = zith_arena_alloc(arena, (size_t) size);
-        if (!buffer) goto error;
+    *out_size = (size_t) st.st_size;
+    return f;
+}
 
-        const size_t read = fread(buffer, 1, (size_t) size, f);
+// Lê 'size' bytes de 'f' para a arena, com '\0' final. Fecha 'f'.
+static char *read_source(ZithArena *arena, FILE *f, const char *path, const size_t size) {
+    char *buffer = zith_arena_alloc_aligned(arena, size + 1, 1);
+    if (!buffer) {
         fclose(f);
+        zith_io_error("Out of memory while loading '%s'", path);
+        return NULL;
+    }
 
-        if (read != (size_t) size) {
-            zith_io_error("Failed to read '%s' (read %zu of %ld bytes)",
-                    path, read, size);
-            *out_size = 0;
-            return NULL;
-        }
+    const size_t read = size ? fread(buffer, 1, size, f) : 0;
+    fclose(f);
 
-        *out_size = (size_t) size;
-        return buffer;
+    if (read != size) {
+        zith_io_error("Failed to read '%s' (read %zu of %zu bytes)", path, read, size);
+        return NULL;
     }
 
-error:
-    fclose(f);
-    zith_io_error("I/O error while loading '%s'", path);
+    buffer[size] = '\0';
+    return buffer;
+}
+
+#ifndef _WIN32
+typedef struct {
+    void *addr;
+    size_t len;
+} SourceMapping;
+
+static void unmap_source(void *ctx) {
+    const SourceMapping *m = ctx;
+    munmap(m->addr, m->len);
+}
+
+// Mapeia o ficheiro seguido de uma página sentinela a zeros: reserva-se
+// tudo como anónimo e o ficheiro é mapeado por cima do início. Os bytes entre
+// o EOF e o fim da última página do ficheiro também são zero.
+static const char *map_source(ZithArena *arena, FILE *f, const size_t size) {
+    const size_t page = (size_t) sysconf(_SC_PAGESIZE);
+    const size_t len = ((size + page - 1) & ~(page - 1)) + page;
+
+    char *base = mmap(NULL, len, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) return NULL;
+    if (mmap(base, size, PROT_READ, MAP_PRIVATE | MAP_FIXED, fileno(f), 0) == MAP_FAILED) {
+        munmap(base, len);
+        return NULL;
+    }
+
+    SourceMapping *m = zith_arena_alloc_aligned(arena, sizeof(SourceMapping), _Alignof(SourceMapping));
+    if (!m) {
+        munmap(base, len);
+        return NULL;
+    }
+    m->addr = base;
+    m->len = len;
+    if (!zith_arena_defer(arena, unmap_source, m)) {
+        munmap(base, len);
+        return NULL;
+    }
+
+#ifdef MADV_SEQUENTIAL
+    madvise(base, size, MADV_SEQUENTIAL);
+#endif
+    return base;
+}
+#endif
+
+// Carrega um ficheiro fonte (.zith) para a arena.
+// Falha com erro descritivo se a extensão não for .zith,
+// o ficheiro não existir, não for regular, ou a leitura falhar.
+char *zith_load_file_to_arena(struct ZithArena *arena,
+                                  const char *path, size_t *out_size) {
+    if (!arena || !path || !out_size) {
+        if (out_size) *out_size = 0;
+        return NULL;
+    }
     *out_size = 0;
-    return NULL;
+
+    size_t size = 0;
+    FILE *f = open_source(path, &size);
+    if (!f) return NULL;
+
+    char *buffer = read_source(arena, f, path, size);
+    if (buffer) *out_size = size;
+    return buffer;
+}
+
+// Como zith_load_file_to_arena, mas ficheiros grandes são mapeados em vez de
+// copiados (no Windows lê sempre para a arena)
+bool zith_source_view_open(ZithArena *arena, const char *path, ZithSourceView *out) {
+    if (!out) return false;
+    out->data = NULL;
+    out->size = 0;
+    out->mapped = false;
+    if (!arena || !path) return false;
+
+    size_t size = 0;
+    FILE *f = open_source(path, &size);
+    if (!f) return false;
+
+#ifndef _WIN32
+    if (size >= ZITH_SOURCE_MMAP_MIN) {
+        const char *mapped = map_source(arena, f, size);
+        if (mapped) {
+            // O mapeamento mantém o ficheiro; o descritor já não é preciso
+            fclose(f);
+            out->data = mapped;
+            out->size = size;
+            out->mapped = true;
+            return true;
+        }
+    }
+#endif
+
+    const char *buffer = read_source(arena, f, path, size);
+    if (!buffer) return false;
+    out->data = buffer;
+    out->size = size;
+    return true;
 }
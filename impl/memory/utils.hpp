@@ -24,13 +24,19 @@
 //   tokens.push(arena, some_token);
 //   ...
 //   size_t count = 0;
-//   ZithToken* flat = tokens.flatten(arena, &count);
+//   ZithToken* flat = tokens.take_contiguous(arena, &count);
+//
+// Os chunks crescem geometricamente (o dobro do anterior, até
+// kMaxChunkBytes). Quando o chunk cheio é a alocação mais recente da arena,
+// é estendido no lugar em vez de se alocar outro — a lista fica num só chunk
+// e take_contiguous() devolve-o sem cópia.
 //
 // Invariantes:
 //   - init() deve ser chamado antes de qualquer push()
 //   - flatten() pode ser chamado zero ou mais vezes; não consome a lista
 //   - a lista e o array produzido por flatten() partilham a mesma arena;
 //     a lifetime de ambos é determinada pela arena
+//   - push() deve receber sempre a arena dada a init()
 // ============================================================================
 
 template<typename T>
@@ -41,7 +47,8 @@ struct ArenaList {
     // espaço para 'capacity' elementos a seguir ao header.
     // Layout em memória:  [ Chunk header | T items[capacity] ]
 
-    struct Chunk {
+    // Padded to alignof(T) so items() starts on a T boundary
+    struct alignas(T) alignas(void *) Chunk {
         Chunk *next;
         size_t len;
         size_t capacity;
@@ -56,10 +63,13 @@ struct ArenaList {
         }
     };
 
+    // Teto do crescimento geométrico, em bytes de items por chunk
+    static constexpr size_t kMaxChunkBytes = 256 * 1024;
+
     Chunk *head_ = nullptr;
     Chunk *tail_ = nullptr;
     size_t total_ = 0;
-    size_t chunk_capacity_ = 0;
+    size_t chunk_capacity_ = 0;  // capacidade do próximo chunk
 
     // ── API pública ──────────────────────────────────────────────────────────
 
@@ -81,7 +91,8 @@ struct ArenaList {
     // Aloca um novo chunk na arena se o atual estiver cheio.
     void push(ZithArena *arena, const T &value) {
         if (!tail_ || tail_->len == tail_->capacity) {
-            alloc_chunk(arena);
+            if (!extend_tail(arena)) alloc_chunk(arena);
+            if (!tail_ || tail_->len == tail_->capacity) return; // arena esgotada
         }
         tail_->items()[tail_->len++] = value;
         total_++;
@@ -94,7 +105,7 @@ struct ArenaList {
         *out_count = total_;
         if (total_ == 0) return nullptr;
 
-        T *arr = static_cast<T *>(zith_arena_alloc(arena, total_ * sizeof(T)));
+        T *arr = static_cast<T *>(zith_arena_alloc_aligned(arena, total_ * sizeof(T), alignof(T)));
         if (!arr) {
             *out_count = 0;
             return nullptr;
@@ -108,6 +119,20 @@ struct ArenaList {
         return arr;
     }
 
+    // Como flatten(), mas sem cópia quando todos os elementos estão num só
+    // chunk: devolve o próprio storage do chunk (e devolve à arena a
+    // capacidade não usada, se o chunk ainda for a alocação mais recente).
+    // 'arena' tem de ser a arena da lista.
+    T *take_contiguous(ZithArena *arena, size_t *out_count) {
+        if (!head_ || head_ != tail_) return flatten(arena, out_count);
+
+        *out_count = total_;
+        if (head_->len < head_->capacity &&
+            zith_arena_try_extend(arena, head_, chunk_bytes(head_->capacity), chunk_bytes(head_->len)))
+            head_->capacity = head_->len;
+        return head_->items();
+    }
+
     // Acesso por índice — O(n/chunk_capacity), útil para debug
     // Não usar em hot paths; prefira flatten() para iteração
     T *at(size_t index) {
@@ -159,15 +184,35 @@ struct ArenaList {
     Iterator end() const { return {nullptr, 0}; }
 
 private:
+    static size_t chunk_bytes(size_t capacity) { return sizeof(Chunk) + capacity * sizeof(T); }
+
+    static size_t grown(size_t capacity) {
+        constexpr size_t max_capacity = kMaxChunkBytes / sizeof(T) > 0 ? kMaxChunkBytes / sizeof(T) : 1;
+        if (capacity >= max_capacity) return capacity;
+        return capacity * 2 < max_capacity ? capacity * 2 : max_capacity;
+    }
+
+    // Dobra o tail no lugar se for a alocação mais recente da arena
+    bool extend_tail(ZithArena *arena) {
+        if (!tail_) return false;
+        const size_t new_capacity = grown(tail_->capacity);
+        if (new_capacity == tail_->capacity) return false;
+        if (!zith_arena_try_extend(arena, tail_, chunk_bytes(tail_->capacity), chunk_bytes(new_capacity)))
+            return false;
+        tail_->capacity = new_capacity;
+        return true;
+    }
+
     // Aloca um novo Chunk na arena e liga-o ao tail
     void alloc_chunk(ZithArena *arena) {
-        const size_t alloc_size = sizeof(Chunk) + chunk_capacity_ * sizeof(T);
-        auto *c = static_cast<Chunk *>(zith_arena_alloc(arena, alloc_size));
+        auto *c = static_cast<Chunk *>(
+            zith_arena_alloc_aligned(arena, chunk_bytes(chunk_capacity_), alignof(Chunk)));
         if (!c) return; // arena esgotada — push seguinte será no-op
 
         c->next = nullptr;
         c->len = 0;
         c->capacity = chunk_capacity_;
+        chunk_capacity_ = grown(chunk_capacity_);
 
         if (tail_) tail_->next = c;
         else head_ = c;
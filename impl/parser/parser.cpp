@@ -1,115 +1,206 @@
 // impl/parser/parser.cpp — Parser entry point and pipeline orchestration
 #include "parser.h"
+#include <algorithm>
+#include <atomic>
 #include <cstring>
+#include <system_error>
+#include <thread>
 #include <vector>
 
 using zith::ArenaList;
 
-// Global storage for imported declarations - cleared each parse
-static std::vector<ZithNode *> g_imported_decls_vec;
-static int g_parser_depth = 0;
-
-bool g_import_loaded_this_file = false;
-
-void parser_set_imported_decls(void *decls, ZithArena *arena) {
-    auto *src = static_cast<ArenaList<ZithNode *> *>(decls);
-    size_t count = 0;
-    ZithNode **items = src->flatten(arena, &count);
-    for (size_t i = 0; i < count; ++i) {
-        g_imported_decls_vec.push_back(items[i]);
-    }
-    g_import_loaded_this_file = true;
-}
-
-void *parser_get_imported_decls(void) {
-    return &g_imported_decls_vec;
-}
-
-void parser_enter_scope(void) { g_parser_depth++; }
-void parser_exit_scope(void) {
-    g_parser_depth--;
-    if (g_parser_depth == 0) {
-        g_imported_decls_vec.clear();
-    }
+static ZithSourceLoc token_end(const ZithToken *t) {
+    return {t->loc.offset + t->lexeme.len};
 }
 
-static ZithNode *expand_unbody(Parser *parent, ZithNode *node);
-
 static ZithNode *run_parser_phase(Parser *p, ZithParserMode mode) {
     p->pos = 0;
     p->panic = false;
     p->had_error = false;
     p->mode = mode;
-    parser_enter_scope();
-
-    if (mode == ZITH_MODE_SCAN) {
-        extern void clear_scanned_symbols();
-        clear_scanned_symbols();
-    }
 
     ArenaList<ZithNode *> decls_b;
     decls_b.init(p->arena, 16);
 
+    // SCAN indexes each declaration over the tokens it consumed
+    ZithArena *scratch = parser_scratch();
+    const ZITH::Arena::Scope scope(scratch);
+    ArenaList<ZithScanSymbol> symbols_b;
+    symbols_b.init(scratch, 16);
+
     while (!parser_is_at_end(p)) {
         size_t pos_before = p->pos;
         ZithNode *decl = parser_parse_declaration(p);
-        if (decl) decls_b.push(p->arena, decl);
+        if (decl) {
+            decls_b.push(p->arena, decl);
+            ZithScanSymbol sym;
+            if (mode == ZITH_MODE_SCAN && p->pos > pos_before &&
+                scan_index_symbol(decl, p->tokens[pos_before].loc, token_end(&p->tokens[p->pos - 1]), &sym))
+                symbols_b.push(scratch, sym);
+        }
         if (p->pos == pos_before && !parser_is_at_end(p)) parser_advance(p);
     }
 
     // Imported functions are registered in SEMA's ctx.functions, not added to AST
 
     size_t count = 0;
-    ZithNode **decls = decls_b.flatten(p->arena, &count);
-    return zith_ast_make_program(p->arena, decls, count);
+    ZithNode **decls = decls_b.take_contiguous(p->arena, &count);
+    ZithNode *program = zith_ast_make_program(p->arena, decls, count);
+
+    if (mode == ZITH_MODE_SCAN) {
+        ZithCompilation *unit = parser_compilation(p);
+        size_t symbol_count = 0;
+        const ZithScanSymbol *symbols = symbols_b.flatten(p->arena, &symbol_count);
+        if (unit) unit->scan_index = scan_index_create(p->arena, program, symbols, symbol_count);
+    }
+    return program;
 }
 
-static ZithNode *expand_unbody(Parser *parent, ZithNode *node) {
-    if (!node) return nullptr;
-
-    if (node->type == ZITH_NODE_UNBODY) {
-        const auto *body_tokens = static_cast<const ZithToken *>(node->data.list.ptr);
-        const size_t body_len = node->data.list.len;
-
-        auto *tokens = static_cast<ZithToken *>(zith_arena_alloc(parent->arena, sizeof(ZithToken) * (body_len + 1)));
-        if (!tokens) return node;
-        if (body_len) memcpy(tokens, body_tokens, sizeof(ZithToken) * body_len);
-        tokens[body_len] = {{nullptr, 0}, node->loc, ZITH_TOKEN_END, 0};
-
-        Parser inner{};
-        parser_init(&inner, parent->arena, parent->source, parent->source_len, parent->filename, {tokens, body_len + 1});
-        inner.mode = ZITH_MODE_EXPAND;
-
-        ArenaList<ZithNode *> stmts_b;
-        stmts_b.init(parent->arena, 16);
-        while (!parser_is_at_end(&inner)) {
-            size_t before = inner.pos;
-            ZithNode *stmt = parser_parse_statement(&inner);
-            if (stmt) stmts_b.push(parent->arena, stmt);
-            if (inner.pos == before && !parser_is_at_end(&inner)) parser_advance(&inner);
-        }
-        size_t count = 0;
-        ZithNode **stmts = stmts_b.flatten(parent->arena, &count);
+// ============================================================================
+// EXPAND
+// ============================================================================
+
+// Below this many body tokens in total, threads cost more than they save
+static constexpr size_t kParallelExpandMinTokens = 16384;
 
-        for (size_t i = 0; i < inner.diags.count; ++i)
-            parser_emit_diag(parent, inner.diags.items[i].loc, inner.diags.items[i].severity, inner.diags.items[i].message);
+// Parses one UNBODY into a BLOCK allocated in 'arena'. Diagnostics go to
+// 'diags'; nothing else is shared, so bodies can expand concurrently
+static ZithNode *expand_body(const Parser *parent, ZithNode *node, ZithArena *arena,
+                             ZithDiagList *diags, bool *had_error) {
+    const auto *body_tokens = static_cast<const ZithToken *>(node->data.list.ptr);
+    const size_t body_len = node->data.list.len;
 
-        return zith_ast_make_block(parent->arena, node->loc, stmts, count);
+    // The statement builder is dead once the block is built
+    ZithArena *scratch = parser_scratch();
+    const ZITH::Arena::Scope scope(scratch);
+
+    // Parse the slice in place: 'count' bounds it and inner.eof stands in
+    // for the END a copy would need. The type column is shared when the
+    // slice lies in the parent's stream
+    const uint8_t *types = nullptr;
+    if (parent->types && body_tokens >= parent->tokens && body_tokens + body_len <= parent->tokens + parent->count)
+        types = parent->types + (body_tokens - parent->tokens);
+
+    Parser inner{};
+    parser_init(&inner, arena, parent->source, parent->source_len, parent->filename,
+                {body_tokens, body_len, types, parent->numbers, parent->number_count});
+    inner.eof.loc = node->loc;
+    inner.mode = ZITH_MODE_EXPAND;
+    inner.compilation = parent->compilation;
+    inner.diags = *diags;
+
+    ArenaList<ZithNode *> stmts_b;
+    stmts_b.init(scratch, 16);
+    while (!parser_is_at_end(&inner)) {
+        size_t before = inner.pos;
+        ZithNode *stmt = parser_parse_statement(&inner);
+        if (stmt) stmts_b.push(scratch, stmt);
+        if (inner.pos == before && !parser_is_at_end(&inner)) parser_advance(&inner);
     }
+    size_t count = 0;
+    ZithNode **stmts = stmts_b.flatten(arena, &count);
+
+    *diags = inner.diags;
+    if (inner.had_error) *had_error = true;
+
+    return zith_ast_make_block(arena, node->loc, stmts, count);
+}
+
+// Functions whose body is still an UNBODY, in source order
+static void collect_unbodies(ZithNode *node, std::vector<ZithFuncPayload *> &out, size_t &tokens) {
+    if (!node) return;
 
     if (node->type == ZITH_NODE_FUNC_DECL) {
         auto *fn = static_cast<ZithFuncPayload *>(node->data.list.ptr);
-        fn->body = expand_unbody(parent, fn->body);
+        if (fn->body && fn->body->type == ZITH_NODE_UNBODY) {
+            out.push_back(fn);
+            tokens += fn->body->data.list.len;
+        }
     } else if (node->type == ZITH_NODE_BLOCK || node->type == ZITH_NODE_PROGRAM) {
         auto **items = static_cast<ZithNode **>(node->data.list.ptr);
         for (size_t i = 0; i < node->data.list.len; ++i)
-            items[i] = expand_unbody(parent, items[i]);
+            collect_unbodies(items[i], out, tokens);
     } else if (node->type == ZITH_NODE_IF) {
-        node->data.kids.b = expand_unbody(parent, node->data.kids.b);
-        node->data.kids.c = expand_unbody(parent, node->data.kids.c);
+        collect_unbodies(node->data.kids.b, out, tokens);
+        collect_unbodies(node->data.kids.c, out, tokens);
+    }
+}
+
+// Bodies are handed out one at a time from a shared counter, so a worker
+// that finishes early keeps taking work. Each worker allocates into its own
+// arena, adopted by the parent's once joined; each body keeps its own
+// diagnostics, appended afterwards in source order
+static void expand_parallel(Parser *parent, const std::vector<ZithFuncPayload *> &fns, const size_t n_workers) {
+    struct Result {
+        ZithDiagList diags{nullptr, 0, 0};
+        bool had_error = false;
+    };
+    std::vector<Result> results(fns.size());
+
+    std::atomic<size_t> next{0};
+    auto work = [&](ZithArena *arena) {
+        for (size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < fns.size();)
+            fns[i]->body = expand_body(parent, fns[i]->body, arena, &results[i].diags, &results[i].had_error);
+    };
+
+    std::vector<ZithArena *> arenas;
+    std::vector<std::thread> threads;
+    for (size_t w = 0; w < n_workers; ++w) {
+        ZithArena *arena = zith_arena_create(0);
+        if (!arena) break;
+        arenas.push_back(arena);
+        if (w == 0) continue;  // the calling thread works in arenas[0]
+        try {
+            threads.emplace_back(work, arena);
+        } catch (const std::system_error &) {
+            break;  // no more threads: the calling thread expands the rest
+        }
+    }
+    work(arenas.empty() ? parent->arena : arenas[0]);
+    for (auto &t: threads) t.join();
+
+    for (ZithArena *arena: arenas) {
+        zith_arena_adopt(parent->arena, arena);
+        zith_arena_destroy(arena);
+    }
+    for (const Result &r: results) {
+        for (size_t k = 0; k < r.diags.count; ++k)
+            parser_emit_diag(parent, r.diags.items[k].loc, r.diags.items[k].severity, r.diags.items[k].message);
+        if (r.had_error) parent->had_error = true;
+    }
+}
+
+ZithNode *parser_expand(Parser *p, ZithNode *root, size_t threads) {
+    if (!root) return nullptr;
+
+    std::vector<ZithFuncPayload *> fns;
+    size_t tokens = 0;
+    collect_unbodies(root, fns, tokens);
+
+    if (threads == 0)
+        threads = tokens < kParallelExpandMinTokens ? 1 : std::max(1u, std::thread::hardware_concurrency());
+    threads = std::min(threads, fns.size());
+
+    if (threads < 2) {
+        for (ZithFuncPayload *fn: fns) fn->body = expand_body(p, fn->body, p->arena, &p->diags, &p->had_error);
+    } else {
+        expand_parallel(p, fns, threads);
     }
+    return root;
+}
+
+// Import prefetch + SCAN, shared by the eager and the lazy entry points
+static ZithNode *scan_file(Parser *p) {
+    // Imported sources are only read during SCAN
+    parser_prefetch_imports(p);
+    ZithNode *scan_root = run_parser_phase(p, ZITH_MODE_SCAN);
+    parser_prefetch_release(p);
+    p->scan_root = scan_root;
 
-    return node;
+#ifdef ZITH_DEBUG_SCAN
+    zith_scan_index_print(p->compilation ? p->compilation->scan_index : nullptr);
+#endif
+    return scan_root;
 }
 
 ZithNode *zith_parse_with_source(ZithArena *arena, const char *source, size_t source_len,
@@ -119,24 +210,69 @@ ZithNode *zith_parse_with_source(ZithArena *arena, const char *source, size_t so
     parser_init(&p, arena, source, source_len, filename, tokens);
     parser_set_import_roots(&p, import_roots, import_root_count);
 
-    ZithNode *scan_root = run_parser_phase(&p, ZITH_MODE_SCAN);
-    p.scan_root = scan_root;
-
-    extern void print_scanned_symbols();
-    print_scanned_symbols();
-
-    ZithNode *expanded = expand_unbody(&p, scan_root);
+    ZithNode *scan_root = scan_file(&p);
+    ZithNode *expanded = parser_expand(&p, scan_root, 0);
 
-    extern void sema_run(Parser *p, ZithNode *root);
     sema_run(&p, expanded);
 
-    // Clear imported decls after sema
-    g_imported_decls_vec.clear();
-    g_parser_depth = 0;
-
-    extern void zith_diag_print_all(const ZithDiagList*, const char*, size_t, const char*);
     zith_diag_print_all(&p.diags, source, source_len, filename);
 
     if (p.had_error) return nullptr;
     return expanded;
-}
\ No newline at end of file
+}
+
+// ============================================================================
+// Lazy parsing
+// ============================================================================
+
+const ZithScanIndex *zith_parse_scan(ZithArena *arena, const char *source, size_t source_len,
+                                     const char *filename, ZithTokenStream tokens,
+                                     const char **import_roots, size_t import_root_count) {
+    auto *unit = static_cast<ZithLazyUnit *>(
+        zith_arena_alloc_aligned(arena, sizeof(ZithLazyUnit), alignof(ZithLazyUnit)));
+    if (!unit) return nullptr;
+    Parser *p = &unit->parser;
+    parser_init(p, arena, source, source_len, filename, tokens);
+    parser_set_import_roots(p, import_roots, import_root_count);
+
+    ZithNode *scan_root = scan_file(p);
+
+    unit->sema = sema_create(p, scan_root);
+
+    zith_diag_print_all(&p->diags, source, source_len, filename);
+    if (p->had_error || !unit->sema) return nullptr;
+
+    std::vector<ZithFuncPayload *> fns;
+    size_t tokens_left = 0;
+    collect_unbodies(scan_root, fns, tokens_left);
+    for (ZithFuncPayload *fn: fns) fn->lazy = unit;
+    return p->compilation ? p->compilation->scan_index : nullptr;
+}
+
+ZithNode *zith_parse_lazy(ZithArena *arena, const char *source, size_t source_len,
+                                  const char *filename, ZithTokenStream tokens,
+                                  const char **import_roots, size_t import_root_count) {
+    const ZithScanIndex *index = zith_parse_scan(arena, source, source_len, filename, tokens,
+                                                 import_roots, import_root_count);
+    return index ? index->program : nullptr;
+}
+
+ZithNode *zith_ast_expand(ZithNode *node) {
+    if (!node || node->type != ZITH_NODE_FUNC_DECL) return nullptr;
+    auto *fn = static_cast<ZithFuncPayload *>(node->data.list.ptr);
+    ZithLazyUnit *unit = fn->lazy;
+    if (!unit) return fn->body_failed ? nullptr : fn->body;
+    fn->lazy = nullptr;
+
+    // Only what this body reports is printed
+    Parser *p = &unit->parser;
+    const size_t first = p->diags.count;
+    p->had_error = false;
+    fn->body = expand_body(p, fn->body, p->arena, &p->diags, &p->had_error);
+    sema_check_function(unit->sema, fn);
+
+    const ZithDiagList fresh{p->diags.items + first, p->diags.count - first, p->diags.count - first};
+    zith_diag_print_all(&fresh, p->source, p->source_len, p->filename);
+    fn->body_failed = p->had_error;
+    return fn->body_failed ? nullptr : fn->body;
+}
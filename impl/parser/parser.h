@@ -39,11 +39,18 @@ ZithNode *parser_parse_block(Parser *p);
 
 void sema_run(Parser *p, ZithNode *root);
 
+// Lazy parsing checks one function at a time: sema_create builds the
+// top-level table once (freed with p->arena), sema_check_function checks a
+// single body against it
+typedef struct ZithSema ZithSema;
+ZithSema *sema_create(Parser *p, ZithNode *root);
+void sema_check_function(ZithSema *s, ZithFuncPayload *fn);
+
 // ============================================================================
 // Convenience API for tests
 // ============================================================================
 
-// Parse a source string using a shared global arena.
+// Parse a source string using the calling thread's test arena.
 // The arena is reset on each call — the previous result becomes invalid.
 // For C++ users, prefer the RAII wrapper `ParseResult` below.
 // Diagnostics are printed to stderr; returns nullptr on lex error.
@@ -53,14 +60,14 @@ ZithNode *zith_parse_test(const char *source);
 // Returns nullptr when semantic errors are produced.
 ZithNode *zith_parse_test_full(const char *source);
 
-// Cleanup the global test arena (call once at end of test suite).
+// Free the calling thread's test arena now (it is also freed at thread exit).
 void zith_test_arena_destroy(void);
 
 #ifdef __cplusplus
 } // extern "C"
 
 // ============================================================================
-// C++ RAII test wrapper — auto-resets the global arena on destruction
+// C++ RAII test wrapper — auto-resets the test arena on destruction
 // ============================================================================
 
 struct ParseResult {
@@ -87,7 +94,7 @@ struct ParseResult {
     ZithNode *operator->() const { return node; }
     explicit operator bool() const { return node != nullptr; }
 
-    // Reset the global arena, invalidating this result.
+    // Reset the test arena, invalidating this result.
     // Safe to call multiple times.
     void reset();
 };
@@ -9,6 +9,7 @@
 #include "../diagnostics/diagnostics.hpp"
 #include "../memory/arena.hpp"
 #include "../types/types.hpp"
+#include "scan_index.hpp"
 
 #ifdef __cplusplus
 extern "C" {
@@ -32,8 +33,14 @@ typedef struct ZithScope {
 typedef struct Parser {
     ZithArena *arena;
     const ZithToken *tokens;
+    const uint8_t *types;  // tokens[i].type, dense; NULL when the stream has none
+    const ZithNumber *numbers;  // numeric literal values by source offset (may be NULL)
+    size_t number_count;
     size_t count;
     size_t pos;
+    // Returned past 'count': a parser over a token slice (EXPAND) stops there
+    // without a copied END, and errors at the end point at 'eof.loc'
+    ZithToken eof;
 
     // Original source — needed to print the error line
     const char *source;
@@ -62,8 +69,22 @@ typedef struct Parser {
     // Import system - allowed import roots (std, utils, c, etc.)
     const char **import_roots;
     size_t import_root_count;
+
+    // Module sources loaded ahead of SCAN (parser_prefetch_imports)
+    struct ZithImportPrefetch *prefetch;
+
+    // State of the whole parse, shared with the parsers of imported modules
+    // and body expansion (parser_compilation)
+    struct ZithCompilation *compilation;
 } Parser;
 
+// A file parsed by zith_parse_lazy: its SCAN parser (source, tokens,
+// diagnostics) and the top-level sema table, kept for zith_ast_expand
+typedef struct ZithLazyUnit {
+    Parser parser;
+    struct ZithSema *sema;
+} ZithLazyUnit;
+
 // ============================================================================
 // Parser init
 // ============================================================================
@@ -74,7 +95,11 @@ void parser_init(Parser *p, ZithArena *arena,
                  ZithTokenStream tokens);
 
 void parser_set_import_roots(Parser *p, const char **roots, size_t count);
-void parser_set_imported_decls(void *decls, ZithArena *arena);
+
+// Thread-local arena for parser temporaries (token copies, list builders,
+// imported module sources). Bracket every use with ZITH::Arena::Scope so it
+// is rewound as soon as the temporaries are dead.
+ZithArena *parser_scratch(void);
 
 // ============================================================================
 // Token navigation
@@ -86,6 +111,9 @@ const ZithToken *parser_peek_ahead(const Parser *p, size_t offset);
 
 const ZithToken *parser_advance(Parser *p);
 
+// Type of the token 'offset' ahead; reads the dense type column when present
+ZithTokenType parser_peek_type(const Parser *p, size_t offset);
+
 bool parser_check(const Parser *p, ZithTokenType type);
 
 bool parser_match(Parser *p, ZithTokenType type);
@@ -131,8 +159,52 @@ void skip_block(Parser *p);
 #ifdef __cplusplus
 } // extern "C"
 
-// Print scanned symbols for debugging (declared in parser_decl.cpp)
-void print_scanned_symbols();
+// ============================================================================
+// Per-compilation state
+// ============================================================================
+
+// Everything one parse accumulates outside the AST. It lives in the arena of
+// the parser that created it and nothing in it is global, so separate
+// zith_parse_with_source calls can run on separate threads.
+struct ZithCompilation {
+    // Top-level declarations of the imported modules, registered by SEMA
+    zith::ArenaList<ZithNode *> imported_decls;
+    // The file's own top-level declarations, built by SCAN
+    ZithScanIndex *scan_index;
+};
+
+// p->compilation, created in p->arena on first use. Parsers of imported
+// modules and expanded bodies take their parent's.
+ZithCompilation *parser_compilation(Parser *p);
+
+// ============================================================================
+// Imports (parser_import.cpp)
+// ============================================================================
+
+// Module file of an import path ("std/io" or "std.io"), relative to the
+// working directory; false if its root is not one of p->import_roots
+bool parser_resolve_import(const Parser *p, const char *path, size_t path_len, std::string *out);
+
+// Pre-scans the top-level imports and loads their files in parallel. The
+// sources stay valid until parser_prefetch_release.
+void parser_prefetch_imports(Parser *p);
+void parser_prefetch_release(Parser *p);
+
+enum class PrefetchResult { NotPrefetched, Failed, Loaded };
+
+// Source of 'file' if the prefetch loaded it. Failed means the load was
+// attempted and already reported.
+PrefetchResult parser_prefetched_source(const Parser *p, const std::string &file, ZithSourceView *out);
+
+// ============================================================================
+// Expansion (parser.cpp)
+// ============================================================================
+
+// Replaces every UNBODY under 'root' with its parsed BLOCK. Bodies are
+// independent, so 'threads' > 1 expands them concurrently; 0 picks one per
+// core once the bodies are large enough to pay for it. Diagnostics land in
+// p->diags in source order whatever the thread count.
+ZithNode *parser_expand(Parser *p, ZithNode *root, size_t threads);
 
 // ============================================================================
 // C++ ParserContext — wraps Parser with DiagManager
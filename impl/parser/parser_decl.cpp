@@ -45,9 +45,10 @@ static ZithNode *capture_unbody(Parser *p) {
     
     // Avança até encontrar o '}' correspondente
     while (!parser_is_at_end(p) && depth > 0) {
-        const ZithToken *t = parser_advance(p);
-        if (t->type == ZITH_TOKEN_LBRACE) depth++;
-        else if (t->type == ZITH_TOKEN_RBRACE) depth--;
+        const ZithTokenType t = parser_peek_type(p, 0);
+        parser_advance(p);
+        if (t == ZITH_TOKEN_LBRACE) depth++;
+        else if (t == ZITH_TOKEN_RBRACE) depth--;
     }
     
     // Calcula quantos tokens estão no corpo (excluindo '{' e '}')
@@ -61,103 +62,6 @@ static ZithNode *capture_unbody(Parser *p) {
     return zith_ast_make_unbody(p->arena, loc, body_tokens, token_count);
 }
 
-// ============================================================================
-// Symbol Registration in SCAN mode
-// ============================================================================
-
-struct ScannedSymbolEntry {
-    const char *name;
-    size_t name_len;
-    int kind;
-    ZithVisibility visibility;
-};
-
-class ScanSymbolCollector {
-public:
-    static ScanSymbolCollector& instance() {
-        static ScanSymbolCollector inst;
-        return inst;
-    }
-
-    void clear() {
-        symbols_.clear();
-    }
-
-    void add_function(const char *name, size_t len, ZithVisibility vis) {
-        ScannedSymbolEntry entry{name, len, 0, vis};
-        symbols_.push_back(entry);
-    }
-
-    void add_struct(const char *name, size_t len, ZithVisibility vis) {
-        ScannedSymbolEntry entry{name, len, 1, vis};
-        symbols_.push_back(entry);
-    }
-
-    void add_trait(const char *name, size_t len, ZithVisibility vis) {
-        ScannedSymbolEntry entry{name, len, 2, vis};
-        symbols_.push_back(entry);
-    }
-
-    void add_enum(const char *name, size_t len, ZithVisibility vis) {
-        ScannedSymbolEntry entry{name, len, 3, vis};
-        symbols_.push_back(entry);
-    }
-
-    void add_import(const char *name, size_t len, ZithVisibility vis) {
-        ScannedSymbolEntry entry{name, len, 4, vis};
-        symbols_.push_back(entry);
-    }
-
-    void print_symbols() const {
-        size_t n = symbols_.size();
-        if (n == 0) { printf("  (no symbols)\n"); return; }
-        for (size_t i = 0; i < n; ++i) {
-            const auto &sym = symbols_[i];
-            const char *kind_str = "???";
-            switch (sym.kind) {
-                case 0: kind_str = "fn"; break;
-                case 1: kind_str = "struct"; break;
-                case 2: kind_str = "trait"; break;
-                case 3: kind_str = "enum"; break;
-                case 4: kind_str = "import"; break;
-            }
-            const char *vis_str = (sym.visibility == ZITH_VIS_PUBLIC) ? "pub" : "priv";
-            printf("  [%s] %.*s (%s)\n", kind_str, (int)sym.name_len, sym.name, vis_str);
-        }
-    }
-
-    size_t count() const { return symbols_.size(); }
-    const ScannedSymbolEntry* data() const { return symbols_.data(); }
-
-private:
-    ScanSymbolCollector() = default;
-    std::vector<ScannedSymbolEntry> symbols_;
-};
-
-void clear_scanned_symbols() {
-    ScanSymbolCollector::instance().clear();
-}
-
-static void register_fn_symbol(Parser *p, const ZithToken *name_tok, ZithVisibility vis) {
-    if (name_tok && p->mode == ZITH_MODE_SCAN) {
-        ScanSymbolCollector::instance().add_function(
-            name_tok->lexeme.data, name_tok->lexeme.len, vis);
-    }
-}
-
-static void register_struct_symbol(Parser *p, const ZithToken *name_tok, ZithVisibility vis) {
-    if (name_tok && p->mode == ZITH_MODE_SCAN) {
-        ScanSymbolCollector::instance().add_struct(
-            name_tok->lexeme.data, name_tok->lexeme.len, vis);
-    }
-}
-
-static void register_import_symbol(Parser *p, const char *name, size_t len, ZithVisibility vis) {
-    if (name && p->mode == ZITH_MODE_SCAN) {
-        ScanSymbolCollector::instance().add_import(name, len, vis);
-    }
-}
-
 static ZithVisibility parse_visibility(Parser *p, ZithVisibility *current_vis) {
     ZithVisibility vis = *current_vis;
     if (parser_check(p, ZITH_TOKEN_MODIFIER)) {
@@ -167,7 +71,7 @@ static ZithVisibility parse_visibility(Parser *p, ZithVisibility *current_vis) {
         else if (l == 9 && strncmp(d, "protected", 9) == 0) vis = ZITH_VIS_PROTECTED;
         else if (l == 7 && strncmp(d, "private", 7) == 0) vis = ZITH_VIS_PRIVATE;
         
-        if (parser_peek_ahead(p, 1)->type == ZITH_TOKEN_COLON) {
+        if (parser_peek_type(p, 1) == ZITH_TOKEN_COLON) {
             parser_advance(p); parser_advance(p); // modifier :
             *current_vis = vis;
             return (ZithVisibility)-1; 
@@ -254,7 +158,7 @@ ZithNode *parser_parse_statement(Parser *p) {
         case ZITH_TOKEN_FOR: {
             parser_advance(p);
             ZithForPayload data = {};
-            if (parser_check(p, ZITH_TOKEN_IDENTIFIER) && parser_peek_ahead(p, 1)->type == ZITH_TOKEN_IN) {
+            if (parser_check(p, ZITH_TOKEN_IDENTIFIER) && parser_peek_type(p, 1) == ZITH_TOKEN_IN) {
                 data.is_for_in = true; data.iterator_var = parser_parse_expression(p);
                 parser_advance(p); // 'in'
                 data.iterable = parser_parse_expression(p);
@@ -296,7 +200,7 @@ ZithNode *parser_parse_block(Parser *p) {
     while (!parser_check(p, ZITH_TOKEN_RBRACE) && !parser_is_at_end(p))
         stmts_b.push(p->arena, parser_parse_statement(p));
     parser_expect(p, ZITH_TOKEN_RBRACE, "expected '}'");
-    size_t count = 0; ZithNode **stmts = stmts_b.flatten(p->arena, &count);
+    size_t count = 0; ZithNode **stmts = stmts_b.take_contiguous(p->arena, &count);
     return zith_ast_make_block(p->arena, loc, stmts, count);
 }
 
@@ -306,12 +210,12 @@ static ZithNode *parse_body(Parser *p) {
         while (!parser_check(p, ZITH_TOKEN_RBRACE) && !parser_is_at_end(p))
             stmts_b.push(p->arena, parser_parse_statement(p));
         parser_expect(p, ZITH_TOKEN_RBRACE, "expected '}'");
-        size_t count = 0; ZithNode **stmts = stmts_b.flatten(p->arena, &count);
+        size_t count = 0; ZithNode **stmts = stmts_b.take_contiguous(p->arena, &count);
         return zith_ast_make_block(p->arena, parser_peek(p)->loc, stmts, count);
     }
     ZithNode *stmt = parser_parse_statement(p);
     if (!stmt) return zith_ast_make_block(p->arena, parser_peek(p)->loc, nullptr, 0);
-    ZithNode **arr = (ZithNode**)zith_arena_alloc(p->arena, sizeof(ZithNode*));
+    ZithNode **arr = (ZithNode**)zith_arena_alloc_aligned(p->arena, sizeof(ZithNode*), alignof(ZithNode*));
     if(arr) *arr = stmt;
     return zith_ast_make_block(p->arena, parser_peek(p)->loc, arr, arr ? 1 : 0);
 }
@@ -329,9 +233,6 @@ static ZithNode *parse_fn_decl(Parser *p, ZithSourceLoc loc, ZithVisibility vis,
     parser_expect(p, ZITH_TOKEN_FN, "expected 'fn' keyword");
     const ZithToken *name = parser_expect(p, ZITH_TOKEN_IDENTIFIER, "expected function name");
     
-    // Register function symbol in SCAN mode
-    register_fn_symbol(p, name, vis);
-    
     parser_expect(p, ZITH_TOKEN_LPAREN, "expected '('");
     ArenaList<ZithNode *> params_b; 
     params_b.init(p->arena, 8);
@@ -358,8 +259,8 @@ static ZithNode *parse_fn_decl(Parser *p, ZithSourceLoc loc, ZithVisibility vis,
         else parser_advance(p);
     }
     
-    size_t pcount = 0; ZithNode **params = params_b.flatten(p->arena, &pcount);
-    return zith_ast_make_func_decl(p->arena, loc, {name->lexeme.data, name->lexeme.len, kind, params, pcount, ret_type, body, vis, is_method});
+    size_t pcount = 0; ZithNode **params = params_b.take_contiguous(p->arena, &pcount);
+    return zith_ast_make_func_decl(p->arena, loc, {name->lexeme.data, name->lexeme.len, kind, params, pcount, ret_type, body, vis, is_method, nullptr, false});
 }
 
 static ZithNode *parse_struct_decl(Parser *p, ZithVisibility struct_vis) {
@@ -367,9 +268,6 @@ static ZithNode *parse_struct_decl(Parser *p, ZithVisibility struct_vis) {
     parser_advance(p); // consume 'struct'
     const ZithToken *name = parser_expect(p, ZITH_TOKEN_IDENTIFIER, "expected struct name");
     
-    // Register struct symbol in SCAN mode
-    register_struct_symbol(p, name, struct_vis);
-    
     parser_expect(p, ZITH_TOKEN_LBRACE, "expected '{'");
 
     ArenaList<ZithNode *> fields_b, methods_b;
@@ -442,11 +340,76 @@ static ZithNode *parse_struct_decl(Parser *p, ZithVisibility struct_vis) {
     parser_expect(p, ZITH_TOKEN_RBRACE, "expected '}'");
 
     size_t fc = 0, mc = 0;
-    ZithNode **fields = fields_b.flatten(p->arena, &fc);
-    ZithNode **methods = methods_b.flatten(p->arena, &mc);
+    ZithNode **fields = fields_b.take_contiguous(p->arena, &fc);
+    ZithNode **methods = methods_b.take_contiguous(p->arena, &mc);
     return zith_ast_make_struct(p->arena, loc, {name->lexeme.data, name->lexeme.len, fields, fc, methods, mc, struct_vis});
 }
 
+// Imported declarations only contribute signatures; their UNBODY bodies point
+// at tokens in scratch memory that is rewound once the module is scanned
+static void detach_imported_bodies(ZithNode *decl) {
+    if (!decl) return;
+    if (decl->type == ZITH_NODE_FUNC_DECL) {
+        auto *fn = static_cast<ZithFuncPayload *>(decl->data.list.ptr);
+        if (fn && fn->body && fn->body->type == ZITH_NODE_UNBODY) fn->body = nullptr;
+    } else if (decl->type == ZITH_NODE_STRUCT_DECL) {
+        const auto *st = static_cast<ZithStructPayload *>(decl->data.list.ptr);
+        if (!st) return;
+        for (size_t i = 0; i < st->method_count; ++i)
+            detach_imported_bodies(st->methods[i]);
+    }
+}
+
+// Loads an allowed module ("root/rel" or "root.rel") and registers its
+// top-level declarations in the compilation for SEMA. Source and tokens live
+// in parser scratch memory; only the AST nodes land in p->arena.
+static void scan_imported_module(Parser *p, const char *path, size_t path_len) {
+    std::string file_path;
+    if (!parser_resolve_import(p, path, path_len, &file_path)) return;
+
+    ZithArena *scratch = parser_scratch();
+    const ZITH::Arena::Scope scope(scratch);
+    ZITH_ARENA_SITE(scratch, ZITH_ARENA_TAG_IMPORTS);
+
+    // Normally prefetched; otherwise mapped or copied into scratch and
+    // released with the scope
+    ZithSourceView view;
+    switch (parser_prefetched_source(p, file_path, &view)) {
+        case PrefetchResult::Loaded: break;
+        case PrefetchResult::Failed: return;
+        case PrefetchResult::NotPrefetched:
+            if (!zith_source_view_open(scratch, file_path.c_str(), &view)) return;
+            break;
+    }
+    if (view.size == 0) return;
+    const char *source = view.data;
+    const size_t file_size = view.size;
+
+    ZithTokenStream tokens = zith_tokenize(scratch, source, file_size);
+    if (!tokens.data) return;
+
+    ZithCompilation *unit = parser_compilation(p);
+    if (!unit) return;
+
+    // imp_parser has no import roots, so the module's own imports are not
+    // resolved (parser_resolve_import rejects them): only its declarations
+    // are registered
+    Parser imp_parser;
+    parser_init(&imp_parser, p->arena, source, file_size, file_path.c_str(), tokens);
+    imp_parser.mode = ZITH_MODE_SCAN;
+    imp_parser.compilation = unit;
+
+    while (!parser_is_at_end(&imp_parser)) {
+        size_t pb = imp_parser.pos;
+        ZithNode *d = parser_parse_declaration(&imp_parser);
+        if (d) {
+            detach_imported_bodies(d);
+            unit->imported_decls.push(p->arena, d);
+        }
+        if (imp_parser.pos == pb && !parser_is_at_end(&imp_parser)) parser_advance(&imp_parser);
+    }
+}
+
 static ZithNode *parse_import_decl(Parser *p) {
     const ZithSourceLoc loc = parser_peek(p)->loc;
     parser_advance(p);  // consome 'import'
@@ -483,62 +446,8 @@ static ZithNode *parse_import_decl(Parser *p) {
     
     parser_expect(p, ZITH_TOKEN_SEMICOLON, "expected ';'");
     ZithImportPayload payload = {zith_arena_str(p->arena, buf, buf_len), buf_len, ZITH_VIS_PRIVATE, alias, alias_len, false, false};
-    register_import_symbol(p, buf, buf_len, ZITH_VIS_PRIVATE);
 
-    if (p->mode == ZITH_MODE_SCAN && p->import_roots && p->import_root_count > 0) {
-        std::string import_path(buf, buf_len);
-        
-        std::string root;
-        std::string rel_path;
-        size_t slash_pos = import_path.find('/');
-        if (slash_pos != std::string::npos) {
-            root = import_path.substr(0, slash_pos);
-            rel_path = import_path.substr(slash_pos + 1);
-        } else {
-            size_t dot_pos = import_path.find('.');
-            if (dot_pos != std::string::npos) {
-                root = import_path.substr(0, dot_pos);
-                rel_path = import_path.substr(dot_pos + 1);
-            } else {
-                root = import_path;
-                rel_path = "";
-            }
-        }
-        
-        bool allowed = false;
-        for (size_t i = 0; i < p->import_root_count; ++i) {
-            if (root == p->import_roots[i]) { allowed = true; break; }
-        }
-        
-        if (allowed && !rel_path.empty()) {
-            std::string file_path = root + "/" + rel_path + ".zith";
-            size_t file_size = 0;
-            char *source = zith_load_file_to_arena(p->arena, file_path.c_str(), &file_size);
-            
-            if (source && file_size > 0) {
-                ZithTokenStream tokens = zith_tokenize(p->arena, source, file_size);
-                if (tokens.data) {
-                    Parser imp_parser;
-                    parser_init(&imp_parser, p->arena, source, file_size, file_path.c_str(), tokens);
-                    imp_parser.mode = ZITH_MODE_SCAN;
-                    
-                    ArenaList<ZithNode *> import_decls;
-                    import_decls.init(p->arena, 16);
-                    while (!parser_is_at_end(&imp_parser)) {
-                        size_t pb = imp_parser.pos;
-                        ZithNode *d = parser_parse_declaration(&imp_parser);
-                        if (d) import_decls.push(p->arena, d);
-                        if (imp_parser.pos == pb && !parser_is_at_end(&imp_parser)) parser_advance(&imp_parser);
-                    }
-                    
-                    if (import_decls.size() > 0) {
-                        extern void parser_set_imported_decls(void *decls, ZithArena *arena);
-                        parser_set_imported_decls(&import_decls, p->arena);
-                    }
-                }
-            }
-        }
-    }
+    if (p->mode == ZITH_MODE_SCAN) scan_imported_module(p, buf, buf_len);
 
     return zith_ast_make_import(p->arena, loc, payload);
 }
@@ -596,7 +505,6 @@ static ZithNode *parse_from_import_decl(Parser *p) {
         false,  // is_export = false
         true    // is_from = true
     };
-    register_import_symbol(p, module_buf, module_len, ZITH_VIS_PRIVATE);
     return zith_ast_make_import(p->arena, loc, payload);
 }
 
@@ -623,66 +531,9 @@ parser_expect(p, ZITH_TOKEN_SEMICOLON, "expected ';'");
     auto alias = "";
     size_t alias_len = 1;
     ZithImportPayload payload = {zith_arena_str(p->arena, buf, buf_len), buf_len, ZITH_VIS_PUBLIC, alias, alias_len, true, false};
-    register_import_symbol(p, buf, buf_len, ZITH_VIS_PUBLIC);
 
     // In SCAN mode, try to load and import the module
-    if (p->mode == ZITH_MODE_SCAN && p->import_roots && p->import_root_count > 0) {
-        std::string import_path(buf, buf_len);
-        
-        // Convert path format: std/io/console -> root=std, path=io/console
-        std::string root;
-        std::string rel_path;
-        size_t slash_pos = import_path.find('/');
-        if (slash_pos != std::string::npos) {
-            root = import_path.substr(0, slash_pos);
-            rel_path = import_path.substr(slash_pos + 1);
-        } else {
-            size_t dot_pos = import_path.find('.');
-            if (dot_pos != std::string::npos) {
-                root = import_path.substr(0, dot_pos);
-                rel_path = import_path.substr(dot_pos + 1);
-            } else {
-                root = import_path;
-                rel_path = "";
-            }
-        }
-        
-        // Check if root is allowed
-        bool allowed = false;
-        for (size_t i = 0; i < p->import_root_count; ++i) {
-            if (root == p->import_roots[i]) { allowed = true; break; }
-        }
-        
-        if (allowed && !rel_path.empty()) {
-            // Build file path - resolve relative to current working directory (project root)
-            std::string file_path = root + "/" + rel_path + ".zith";
-            size_t file_size = 0;
-            char *source = zith_load_file_to_arena(p->arena, file_path.c_str(), &file_size);
-            
-            if (source && file_size > 0) {
-                ZithTokenStream tokens = zith_tokenize(p->arena, source, file_size);
-                if (tokens.data) {
-                    Parser imp_parser;
-                    parser_init(&imp_parser, p->arena, source, file_size, file_path.c_str(), tokens);
-                    imp_parser.mode = ZITH_MODE_SCAN;
-                    
-                    ArenaList<ZithNode *> import_decls;
-                    import_decls.init(p->arena, 16);
-                    while (!parser_is_at_end(&imp_parser)) {
-                        size_t pb = imp_parser.pos;
-                        ZithNode *d = parser_parse_declaration(&imp_parser);
-                        if (d) import_decls.push(p->arena, d);
-                        if (imp_parser.pos == pb && !parser_is_at_end(&imp_parser)) parser_advance(&imp_parser);
-                    }
-                    
-                    if (import_decls.size() > 0) {
-                        extern void parser_set_imported_decls(void *decls, ZithArena *arena);
-                        parser_set_imported_decls(&import_decls, p->arena);
-                    }
-                }
-            }
-        }
-    }
+    if (p->mode == ZITH_MODE_SCAN) scan_imported_module(p, buf, buf_len);
 
     return zith_ast_make_import(p->arena, loc, payload);
 }
@@ -709,10 +560,3 @@ ZithNode *parser_parse_declaration(Parser *p) {
     parser_match(p, ZITH_TOKEN_SEMICOLON);
     return expr;
 }
-
-#ifdef __cplusplus
-void print_scanned_symbols() {
-    printf("Scanned symbols:\n");
-    ScanSymbolCollector::instance().print_symbols();
-}
-#endif
\ No newline at end of file
@@ -15,7 +15,7 @@ extern bool parser_check(const Parser *p, ZithTokenType type);
 extern bool parser_match(Parser *p, ZithTokenType type);
 extern const ZithToken *parser_expect(Parser *p, ZithTokenType type, const char *msg);
 extern void parser_error(Parser *p, const ZithSourceLoc loc, const char *msg);
-extern ZithLiteral parse_lit_number(const char*, size_t, ZithTokenType);
+extern ZithLiteral parser_number_literal(const Parser *p, const ZithToken *t);
 
 // ============================================================================
 // Types
@@ -95,7 +95,7 @@ static ZithNode *parse_nud(Parser *p) {
     switch (t->type) {
         case ZITH_TOKEN_NUMBER: case ZITH_TOKEN_FLOAT: case ZITH_TOKEN_HEXADECIMAL:
         case ZITH_TOKEN_BINARY: case ZITH_TOKEN_OCTAL:
-            return zith_ast_make_literal(p->arena, loc, parse_lit_number(t->lexeme.data, t->lexeme.len, t->type));
+            return zith_ast_make_literal(p->arena, loc, parser_number_literal(p, t));
         case ZITH_TOKEN_STRING:
             return zith_ast_make_literal(p->arena, loc, {ZITH_LIT_STRING, {.string = {t->lexeme.data + 1, t->lexeme.len - 2}}});
         case ZITH_TOKEN_IDENTIFIER: {
@@ -107,7 +107,7 @@ static ZithNode *parse_nud(Parser *p) {
                 if (!parser_match(p, ZITH_TOKEN_COMMA)) break;
             }
             parser_expect(p, ZITH_TOKEN_RPAREN, "expected ')'");
-            size_t count = 0; ZithNode **args = args_b.flatten(p->arena, &count);
+            size_t count = 0; ZithNode **args = args_b.take_contiguous(p->arena, &count);
             return zith_ast_make_call(p->arena, loc, ident, args, count);
         }
         case ZITH_TOKEN_MINUS: case ZITH_TOKEN_BANG:
@@ -145,7 +145,7 @@ static ZithNode *parse_expr_bp(Parser *p, int min_bp) {
                     if (!parser_match(p, ZITH_TOKEN_COMMA)) break;
                 }
                 parser_expect(p, ZITH_TOKEN_RPAREN, "expected ')'");
-                size_t ac = 0; ZithNode **args = args_b.flatten(p->arena, &ac);
+                size_t ac = 0; ZithNode **args = args_b.take_contiguous(p->arena, &ac);
                 left = zith_ast_make_call(p->arena, loc, left, args, ac);
             }
             continue;
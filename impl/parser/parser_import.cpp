@@ -0,0 +1,198 @@
+// impl/parser/parser_import.cpp — Import resolution and prefetch
+//
+// SCAN loads an imported module when it reaches the import declaration.
+// parser_prefetch_imports() runs before that: a pre-scan of the top-level
+// tokens collects the import/export paths, and their files are read on a few
+// worker threads so the I/O of a whole import set overlaps instead of being
+// serialized in the middle of parsing. scan_imported_module then takes the
+// loaded source from the prefetch.
+#include "parser.h"
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+// Upper bound on worker threads; the reads are I/O-bound, not CPU-bound
+static constexpr size_t kMaxPrefetchThreads = 8;
+
+struct ZithImportPrefetch {
+    struct Entry {
+        std::string file;
+        ZithSourceView view{};
+        bool ok = false;
+    };
+
+    ZithArena *arena = nullptr;  // owns the loaded sources and mappings
+    std::vector<Entry> entries;
+};
+
+// ============================================================================
+// Resolution
+// ============================================================================
+
+bool parser_resolve_import(const Parser *p, const char *path, size_t path_len, std::string *out) {
+    if (!p->import_roots || p->import_root_count == 0) return false;
+
+    std::string import_path(path, path_len);
+
+    // Convert path format: std/io/console -> root=std, path=io/console
+    std::string root;
+    std::string rel_path;
+    size_t slash_pos = import_path.find('/');
+    if (slash_pos != std::string::npos) {
+        root = import_path.substr(0, slash_pos);
+        rel_path = import_path.substr(slash_pos + 1);
+    } else {
+        size_t dot_pos = import_path.find('.');
+        if (dot_pos != std::string::npos) {
+            root = import_path.substr(0, dot_pos);
+            rel_path = import_path.substr(dot_pos + 1);
+        } else {
+            root = import_path;
+            rel_path = "";
+        }
+    }
+
+    // Check if root is allowed
+    bool allowed = false;
+    for (size_t i = 0; i < p->import_root_count; ++i) {
+        if (root == p->import_roots[i]) { allowed = true; break; }
+    }
+    if (!allowed || rel_path.empty()) return false;
+
+    // Resolved relative to the current working directory (project root)
+    *out = root + "/" + rel_path + ".zith";
+    return true;
+}
+
+// ============================================================================
+// Prefetch
+// ============================================================================
+
+// Paths of the top-level import/export declarations, spelled the way
+// parse_import_decl / parse_export_decl build them. Bodies are skipped —
+// SCAN never loads imports from inside them — and so is 'from m import x',
+// which does not load m.
+static std::vector<std::string> prescan_import_paths(const Parser *p) {
+    std::vector<std::string> paths;
+    auto type_at = [p](const size_t i) {
+        return p->types ? static_cast<ZithTokenType>(p->types[i]) : p->tokens[i].type;
+    };
+    int depth = 0;
+    for (size_t i = 0; i < p->count; ++i) {
+        const ZithTokenType type = type_at(i);
+        if (type == ZITH_TOKEN_LBRACE) { ++depth; continue; }
+        if (type == ZITH_TOKEN_RBRACE) { if (depth > 0) --depth; continue; }
+        if (depth > 0) continue;
+
+        if (type == ZITH_TOKEN_FROM) {
+            while (i + 1 < p->count && type_at(i + 1) != ZITH_TOKEN_IMPORT &&
+                   type_at(i + 1) != ZITH_TOKEN_SEMICOLON)
+                ++i;
+            ++i;
+            continue;
+        }
+        if (type != ZITH_TOKEN_IMPORT && type != ZITH_TOKEN_EXPORT) continue;
+
+        size_t j = i + 1;
+        if (j >= p->count || type_at(j) != ZITH_TOKEN_IDENTIFIER) continue;
+
+        // Exports only take '.' separators
+        const bool slashes = type == ZITH_TOKEN_IMPORT;
+        std::string path(p->tokens[j].lexeme.data, p->tokens[j].lexeme.len);
+        ++j;
+        while (j + 1 < p->count && type_at(j + 1) == ZITH_TOKEN_IDENTIFIER &&
+               (type_at(j) == ZITH_TOKEN_DOT || (slashes && type_at(j) == ZITH_TOKEN_DIVIDE))) {
+            path += type_at(j) == ZITH_TOKEN_DOT ? '.' : '/';
+            path.append(p->tokens[j + 1].lexeme.data, p->tokens[j + 1].lexeme.len);
+            j += 2;
+        }
+        paths.push_back(std::move(path));
+        i = j - 1;
+    }
+    return paths;
+}
+
+// Faults a mapped source in, so the disk read happens on the worker
+static void touch_pages(const ZithSourceView &view) {
+    unsigned char sum = 0;
+    for (size_t i = 0; i < view.size; i += 4096) sum ^= static_cast<unsigned char>(view.data[i]);
+    volatile unsigned char sink = sum;
+    (void) sink;
+}
+
+void parser_prefetch_imports(Parser *p) {
+    if (!p || p->prefetch || !p->import_roots || p->import_root_count == 0) return;
+
+    std::vector<std::string> files;
+    for (const auto &path: prescan_import_paths(p)) {
+        std::string file;
+        if (parser_resolve_import(p, path.data(), path.size(), &file) &&
+            std::find(files.begin(), files.end(), file) == files.end())
+            files.push_back(std::move(file));
+    }
+    if (files.empty()) return;
+
+    auto *pf = new ZithImportPrefetch;
+    pf->arena = zith_arena_create(0);
+    if (!pf->arena) {
+        delete pf;
+        return;
+    }
+    pf->entries.resize(files.size());
+    for (size_t i = 0; i < files.size(); ++i) pf->entries[i].file = std::move(files[i]);
+
+    std::atomic<size_t> next{0};
+    auto work = [pf, &next](ZithArena *arena) {
+        for (size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < pf->entries.size();) {
+            auto &e = pf->entries[i];
+            e.ok = zith_source_view_open(arena, e.file.c_str(), &e.view);
+            if (e.ok && e.view.mapped) touch_pages(e.view);
+        }
+    };
+
+    // Each worker loads into its own arena; they are adopted once joined
+    const size_t hw = std::max(1u, std::thread::hardware_concurrency());
+    const size_t n_workers = std::min({pf->entries.size(), hw, kMaxPrefetchThreads});
+    std::vector<ZithArena *> arenas;
+    std::vector<std::thread> threads;
+    for (size_t w = 1; w < n_workers; ++w) {
+        ZithArena *arena = zith_arena_create(0);
+        if (!arena) break;
+        arenas.push_back(arena);
+        try {
+            threads.emplace_back(work, arena);
+        } catch (const std::system_error &) {
+            break;  // no threads available: the calling thread loads the rest
+        }
+    }
+    work(pf->arena);
+    for (auto &t: threads) t.join();
+    for (ZithArena *arena: arenas) {
+        zith_arena_adopt(pf->arena, arena);
+        zith_arena_destroy(arena);
+    }
+
+    p->prefetch = pf;
+}
+
+PrefetchResult parser_prefetched_source(const Parser *p, const std::string &file, ZithSourceView *out) {
+    if (!p->prefetch) return PrefetchResult::NotPrefetched;
+    for (const auto &e: p->prefetch->entries) {
+        if (e.file != file) continue;
+        if (!e.ok) return PrefetchResult::Failed;
+        *out = e.view;
+        return PrefetchResult::Loaded;
+    }
+    return PrefetchResult::NotPrefetched;
+}
+
+void parser_prefetch_release(Parser *p) {
+    if (!p || !p->prefetch) return;
+    zith_arena_destroy(p->prefetch->arena);
+    delete p->prefetch;
+    p->prefetch = nullptr;
+}
@@ -6,6 +6,7 @@
 #include "parser.h"
 #include <cstring>
 #include <cstdio>
+#include <new>
 #include <string>
 #include <vector>
 #include <ankerl/unordered_dense.h>
@@ -294,16 +295,12 @@ static bool sema_validate_import(Parser *p, const char *path, size_t path_len, Z
     return false;
 }
 
-void sema_run(Parser *p, ZithNode *root) {
-    if (!root || root->type != ZITH_NODE_PROGRAM) return;
-    SemaContext ctx{};
+// Top-level table: every function, the imported ones and the import roots
+static void sema_collect(SemaContext &ctx, Parser *p, ZithNode *root) {
     ctx.p = p;
 
-    extern void *parser_get_imported_decls(void);
-    void *imported_decls_ptr = parser_get_imported_decls();
-    if (imported_decls_ptr) {
-        auto *imported_vec = static_cast<std::vector<ZithNode *> *>(imported_decls_ptr);
-        for (auto *decl : *imported_vec) {
+    if (p->compilation) {
+        for (ZithNode *decl : p->compilation->imported_decls) {
             if (decl && decl->type == ZITH_NODE_FUNC_DECL) {
                 auto *fn = static_cast<ZithFuncPayload *>(decl->data.list.ptr);
                 if (fn && fn->name) {
@@ -342,19 +339,53 @@ void sema_run(Parser *p, ZithNode *root) {
             }
         }
     }
+}
+
+static void sema_function(SemaContext &ctx, ZithFuncPayload *fn) {
+    sema_push_scope(ctx);
+    ctx.current_return = sema_type_from_node(fn->return_type);
+    if (ctx.current_return.base == SemaType::Unknown) ctx.current_return = {SemaType::Void, false, false};
+    for (size_t pi = 0; pi < fn->param_count; ++pi) {
+        auto *param = static_cast<ZithParamPayload *>(fn->params[pi]->data.list.ptr);
+        sema_define(ctx, std::string(param->name, param->name_len), sema_type_from_node(param->type_node));
+    }
+    sema_stmt(ctx, fn->body);
+    sema_pop_scope(ctx);
+}
+
+void sema_run(Parser *p, ZithNode *root) {
+    if (!root || root->type != ZITH_NODE_PROGRAM) return;
+    SemaContext ctx{};
+    sema_collect(ctx, p, root);
 
+    auto **decls = static_cast<ZithNode **>(root->data.list.ptr);
     for (size_t i = 0; i < root->data.list.len; ++i) {
         ZithNode *decl = decls[i];
         if (!decl || decl->type != ZITH_NODE_FUNC_DECL) continue;
-        auto *fn = static_cast<ZithFuncPayload *>(decl->data.list.ptr);
-        sema_push_scope(ctx);
-        ctx.current_return = sema_type_from_node(fn->return_type);
-        if (ctx.current_return.base == SemaType::Unknown) ctx.current_return = {SemaType::Void, false, false};
-        for (size_t pi = 0; pi < fn->param_count; ++pi) {
-            auto *param = static_cast<ZithParamPayload *>(fn->params[pi]->data.list.ptr);
-            sema_define(ctx, std::string(param->name, param->name_len), sema_type_from_node(param->type_node));
-        }
-        sema_stmt(ctx, fn->body);
-        sema_pop_scope(ctx);
+        sema_function(ctx, static_cast<ZithFuncPayload *>(decl->data.list.ptr));
     }
-}
\ No newline at end of file
+}
+
+// ============================================================================
+// Per-function sema (lazy parsing)
+// ============================================================================
+
+struct ZithSema {
+    SemaContext ctx;
+};
+
+ZithSema *sema_create(Parser *p, ZithNode *root) {
+    if (!root || root->type != ZITH_NODE_PROGRAM) return nullptr;
+    auto *s = new (std::nothrow) ZithSema{};
+    if (!s) return nullptr;
+    if (!zith_arena_defer(p->arena, [](void *ctx) { delete static_cast<ZithSema *>(ctx); }, s)) {
+        delete s;
+        return nullptr;
+    }
+    sema_collect(s->ctx, p, root);
+    return s;
+}
+
+void sema_check_function(ZithSema *s, ZithFuncPayload *fn) {
+    if (s && fn) sema_function(s->ctx, fn);
+}
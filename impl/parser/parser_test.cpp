@@ -5,12 +5,17 @@
 #include "parser.h"
 #include <cstring>
 
-static ZithArena *g_test_arena = nullptr;
+// One per thread, so tests may parse concurrently; freed when the thread exits
+struct TestArena {
+    ZithArena *arena = nullptr;
+    ~TestArena() { zith_arena_destroy(arena); }
+};
+static thread_local TestArena g_test_arena;
 
 static ZithArena *test_arena_or_init() {
-    if (!g_test_arena) g_test_arena = zith_arena_create(1 << 20);
-    else zith_arena_reset(g_test_arena);
-    return g_test_arena;
+    if (!g_test_arena.arena) g_test_arena.arena = zith_arena_create(1 << 20);
+    else zith_arena_reset(g_test_arena.arena);
+    return g_test_arena.arena;
 }
 
 ZithNode *zith_parse_test(const char *source) {
@@ -31,9 +36,6 @@ ZithNode *zith_parse_test(const char *source) {
     p.had_error = false;
     p.mode = ZITH_MODE_SCAN;
 
-    extern void clear_scanned_symbols();
-    clear_scanned_symbols();
-
     zith::ArenaList<ZithNode *> decls_b;
     decls_b.init(p.arena, 16);
 
@@ -45,7 +47,7 @@ ZithNode *zith_parse_test(const char *source) {
     }
 
     size_t count = 0;
-    ZithNode **decls = decls_b.flatten(p.arena, &count);
+    ZithNode **decls = decls_b.take_contiguous(p.arena, &count);
     return zith_ast_make_program(p.arena, decls, count);
 }
 
@@ -63,13 +65,13 @@ ZithNode *zith_parse_test_full(const char *source) {
 }
 
 void zith_test_arena_destroy(void) {
-    if (g_test_arena) { zith_arena_destroy(g_test_arena); g_test_arena = nullptr; }
+    if (g_test_arena.arena) { zith_arena_destroy(g_test_arena.arena); g_test_arena.arena = nullptr; }
 }
 
 #ifdef __cplusplus
 void ParseResult::reset() {
     if (node) {
-        if (g_test_arena) zith_arena_reset(g_test_arena);
+        if (g_test_arena.arena) zith_arena_reset(g_test_arena.arena);
         node = nullptr;
     }
 }
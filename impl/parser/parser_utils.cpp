@@ -7,6 +7,7 @@
 #include "../diagnostics/diagnostics.hpp"
 #include <cstring>
 #include <cstdlib>
+#include <new>
 
 // ============================================================================
 // Parser Init
@@ -21,8 +22,12 @@ void parser_init(Parser *p, ZithArena *arena,
     p->source_len = source_len;
     p->filename = filename ? filename : "<input>";
     p->tokens = tokens.data;
+    p->types = tokens.types;
+    p->numbers = tokens.numbers;
+    p->number_count = tokens.number_count;
     p->count = tokens.len;
     p->pos = 0;
+    p->eof = {{nullptr, 0}, {0}, ZITH_TOKEN_END, 0};
     p->had_error = false;
     p->panic = false;
     p->fn_kind = ZITH_FN_NORMAL;
@@ -33,6 +38,24 @@ void parser_init(Parser *p, ZithArena *arena,
     p->scan_root = nullptr;
     p->import_roots = nullptr;
     p->import_root_count = 0;
+    p->prefetch = nullptr;
+    p->compilation = nullptr;
+}
+
+ZithArena *parser_scratch(void) {
+    thread_local ZITH::Arena scratch;
+    return scratch.get();
+}
+
+ZithCompilation *parser_compilation(Parser *p) {
+    if (!p->compilation) {
+        void *mem = zith_arena_alloc_aligned(p->arena, sizeof(ZithCompilation), alignof(ZithCompilation));
+        if (!mem) return nullptr;
+        auto *unit = new (mem) ZithCompilation{};
+        unit->imported_decls.init(p->arena, 16);
+        p->compilation = unit;
+    }
+    return p->compilation;
 }
 
 // ============================================================================
@@ -41,15 +64,13 @@ void parser_init(Parser *p, ZithArena *arena,
 
 const ZithToken *parser_peek(const Parser *p) {
     if (p->pos < p->count) return &p->tokens[p->pos];
-    static constexpr ZithToken eof = {{nullptr, 0}, {0, 0}, ZITH_TOKEN_END, 0};
-    return &eof;
+    return &p->eof;
 }
 
 const ZithToken *parser_peek_ahead(const Parser *p, size_t offset) {
     size_t idx = p->pos + offset;
     if (idx < p->count) return &p->tokens[idx];
-    static constexpr ZithToken eof = {{nullptr, 0}, {0, 0}, ZITH_TOKEN_END, 0};
-    return &eof;
+    return &p->eof;
 }
 
 const ZithToken *parser_advance(Parser *p) {
@@ -58,8 +79,14 @@ const ZithToken *parser_advance(Parser *p) {
     return t;
 }
 
+ZithTokenType parser_peek_type(const Parser *p, size_t offset) {
+    const size_t idx = p->pos + offset;
+    if (idx >= p->count) return ZITH_TOKEN_END;
+    return p->types ? static_cast<ZithTokenType>(p->types[idx]) : p->tokens[idx].type;
+}
+
 bool parser_check(const Parser *p, ZithTokenType type) {
-    return parser_peek(p)->type == type;
+    return parser_peek_type(p, 0) == type;
 }
 
 bool parser_match(Parser *p, ZithTokenType type) {
@@ -81,7 +108,7 @@ const ZithToken *parser_expect(Parser *p, ZithTokenType type, const char *msg) {
     return t;
 }
 
-bool parser_is_at_end(const Parser *p) { return parser_peek(p)->type == ZITH_TOKEN_END; }
+bool parser_is_at_end(const Parser *p) { return parser_peek_type(p, 0) == ZITH_TOKEN_END; }
 
 bool parser_check_kw(const Parser *p, const char *kw) {
     const ZithToken *t = parser_peek(p);
@@ -99,10 +126,11 @@ bool check_kw(const Parser *p, const char *kw) { return parser_check_kw(p, kw);
 
 void parser_emit_diag(Parser *p, ZithSourceLoc loc,
                       ZithDiagSeverity severity, const char *msg) {
+    ZITH_ARENA_SITE(p->arena, ZITH_ARENA_TAG_DIAGNOSTICS);
     if (p->diags.count >= p->diags.capacity) {
         size_t new_cap = p->diags.capacity == 0 ? 8 : p->diags.capacity * 2;
         auto *buf = static_cast<ZithDiagnostic *>(
-            zith_arena_alloc(p->arena, new_cap * sizeof(ZithDiagnostic)));
+            zith_arena_alloc_aligned(p->arena, new_cap * sizeof(ZithDiagnostic), alignof(ZithDiagnostic)));
         if (!buf) return;
         if (p->diags.items)
             memcpy(buf, p->diags.items, p->diags.count * sizeof(ZithDiagnostic));
@@ -127,7 +155,7 @@ void parser_synchronize(Parser *p) {
         }
 
         // Stop if we hit a token that starts a new declaration/statement
-        switch (parser_peek(p)->type) {
+        switch (parser_peek_type(p, 0)) {
             case ZITH_TOKEN_FN:
             case ZITH_TOKEN_STRUCT:
             case ZITH_TOKEN_ENUM:
@@ -211,4 +239,21 @@ ZithLiteral parse_lit_number(const char *data, size_t len, ZithTokenType type) {
         lit.kind = ZITH_LIT_INT; lit.value.i64 = (int64_t)strtoll(buf, nullptr, 10);
     }
     return lit;
+}
+
+static_assert((int) ZITH_NUMBER_INT == (int) ZITH_LIT_INT && (int) ZITH_NUMBER_UINT == (int) ZITH_LIT_UINT &&
+              (int) ZITH_NUMBER_FLOAT == (int) ZITH_LIT_FLOAT, "number kinds mirror literal kinds");
+
+// Value the lexer already computed, or a parse of the lexeme when the stream
+// has no entry for this token
+ZithLiteral parser_number_literal(const Parser *p, const ZithToken *t) {
+    const ZithTokenStream view{nullptr, 0, nullptr, p->numbers, p->number_count};
+    if (const ZithNumber *n = zith_token_number(&view, t->loc.offset)) {
+        ZithLiteral lit = {};
+        lit.kind = (ZithLiteralKind) n->kind;
+        if (n->kind == ZITH_NUMBER_FLOAT) lit.value.f64 = n->value.f64;
+        else lit.value.u64 = n->value.u64;
+        return lit;
+    }
+    return parse_lit_number(t->lexeme.data, t->lexeme.len, t->type);
 }
\ No newline at end of file
@@ -0,0 +1,100 @@
+// impl/parser/scan_index.cpp — Top-level symbol index built during SCAN
+#include "scan_index.hpp"
+#include <cstdio>
+#include <cstring>
+
+static uint64_t scan_hash(const char *name, size_t len) {
+    uint64_t h = 0xcbf29ce484222325ull;  // FNV-1a
+    for (size_t i = 0; i < len; ++i) {
+        h ^= static_cast<unsigned char>(name[i]);
+        h *= 0x100000001b3ull;
+    }
+    return h;
+}
+
+bool scan_index_symbol(ZithNode *decl, ZithSourceLoc begin, ZithSourceLoc end, ZithScanSymbol *out) {
+    if (!decl || !decl->data.list.ptr) return false;
+
+    switch (decl->type) {
+        case ZITH_NODE_FUNC_DECL: {
+            const auto *fn = static_cast<const ZithFuncPayload *>(decl->data.list.ptr);
+            *out = {fn->name, fn->name_len, ZITH_SCAN_FN, fn->visibility, decl, begin, end};
+            break;
+        }
+        case ZITH_NODE_STRUCT_DECL: {
+            const auto *st = static_cast<const ZithStructPayload *>(decl->data.list.ptr);
+            *out = {st->name, st->name_len, ZITH_SCAN_STRUCT, st->visibility, decl, begin, end};
+            break;
+        }
+        case ZITH_NODE_VAR_DECL: {
+            const auto *var = static_cast<const ZithVarPayload *>(decl->data.list.ptr);
+            if (var->binding != ZITH_BINDING_CONST) return false;
+            *out = {var->name, var->name_len, ZITH_SCAN_CONST, var->visibility, decl, begin, end};
+            break;
+        }
+        case ZITH_NODE_IMPORT:
+        case ZITH_NODE_EXPORT: {
+            const auto *imp = static_cast<const ZithImportPayload *>(decl->data.list.ptr);
+            const ZithScanKind kind = imp->is_export ? ZITH_SCAN_EXPORT : ZITH_SCAN_IMPORT;
+            *out = {imp->path, imp->path_len, kind, imp->vis, decl, begin, end};
+            break;
+        }
+        default:
+            return false;
+    }
+    return out->name != nullptr;
+}
+
+ZithScanIndex *scan_index_create(ZithArena *arena, ZithNode *program,
+                                 const ZithScanSymbol *symbols, size_t count) {
+    auto *index = static_cast<ZithScanIndex *>(
+        zith_arena_alloc_aligned(arena, sizeof(ZithScanIndex), alignof(ZithScanIndex)));
+    if (!index) return nullptr;
+
+    // At most half full, so probes stay short
+    size_t slot_count = 8;
+    while (slot_count < count * 2) slot_count *= 2;
+    auto *slots = static_cast<uint32_t *>(
+        zith_arena_alloc_aligned(arena, slot_count * sizeof(uint32_t), alignof(uint32_t)));
+    if (!slots) return nullptr;
+    memset(slots, 0, slot_count * sizeof(uint32_t));
+
+    *index = {program, symbols, count, slots, slot_count - 1};
+
+    // Duplicates keep the first slot: find returns the earliest declaration
+    for (size_t i = 0; i < count; ++i) {
+        if (zith_scan_index_find(index, symbols[i].name, symbols[i].name_len)) continue;
+        size_t s = scan_hash(symbols[i].name, symbols[i].name_len) & index->slot_mask;
+        while (slots[s]) s = (s + 1) & index->slot_mask;
+        slots[s] = static_cast<uint32_t>(i + 1);
+    }
+    return index;
+}
+
+const ZithScanSymbol *zith_scan_index_find(const ZithScanIndex *index, const char *name, size_t name_len) {
+    if (!index || !name) return nullptr;
+    for (size_t s = scan_hash(name, name_len) & index->slot_mask; index->slots[s]; s = (s + 1) & index->slot_mask) {
+        const ZithScanSymbol *sym = &index->symbols[index->slots[s] - 1];
+        if (sym->name_len == name_len && memcmp(sym->name, name, name_len) == 0) return sym;
+    }
+    return nullptr;
+}
+
+void zith_scan_index_print(const ZithScanIndex *index) {
+    printf("Scanned symbols:\n");
+    if (!index || index->count == 0) { printf("  (no symbols)\n"); return; }
+    for (size_t i = 0; i < index->count; ++i) {
+        const ZithScanSymbol &sym = index->symbols[i];
+        const char *kind_str = "???";
+        switch (sym.kind) {
+            case ZITH_SCAN_FN: kind_str = "fn"; break;
+            case ZITH_SCAN_STRUCT: kind_str = "struct"; break;
+            case ZITH_SCAN_CONST: kind_str = "const"; break;
+            case ZITH_SCAN_IMPORT: kind_str = "import"; break;
+            case ZITH_SCAN_EXPORT: kind_str = "export"; break;
+        }
+        const char *vis_str = (sym.visibility == ZITH_VIS_PUBLIC) ? "pub" : "priv";
+        printf("  [%s] %.*s (%s) @%zu..%zu\n", kind_str, (int)sym.name_len, sym.name, vis_str,
+               sym.begin.offset, sym.end.offset);
+    }
+}
@@ -0,0 +1,63 @@
+// impl/parser/scan_index.hpp — Top-level symbols recorded by SCAN
+//
+// SCAN builds one index per parsed file: every top-level declaration with its
+// kind, visibility, node and source range, in source order, plus a hash table
+// from name to symbol. Everything lives in the parse's arena.
+#pragma once
+
+#include <zith/zith.hpp>
+#include "../ast/ast.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum ZithScanKind {
+    ZITH_SCAN_FN     = 0,
+    ZITH_SCAN_STRUCT = 1,
+    ZITH_SCAN_CONST  = 2,
+    ZITH_SCAN_IMPORT = 3,  // name is the module path
+    ZITH_SCAN_EXPORT = 4,  // name is the exported path
+} ZithScanKind;
+
+typedef struct ZithScanSymbol {
+    const char *name;
+    size_t name_len;
+    ZithScanKind kind;
+    ZithVisibility visibility;
+    ZithNode *decl;       // FUNC_DECL bodies stay UNBODY until expanded
+    ZithSourceLoc begin;  // first byte of the declaration
+    ZithSourceLoc end;    // one past its last byte
+} ZithScanSymbol;
+
+struct ZithScanIndex {
+    ZithNode *program;
+    const ZithScanSymbol *symbols;  // source order
+    size_t count;
+    // Open addressing, power-of-two sized: symbol index + 1, 0 = empty
+    uint32_t *slots;
+    size_t slot_mask;
+};
+
+// First symbol called 'name' in source order, or NULL. Names may repeat
+// (an import listed twice); walk 'symbols' to see every one.
+const ZithScanSymbol *zith_scan_index_find(const ZithScanIndex *index, const char *name, size_t name_len);
+
+// Debug listing of every symbol on stdout
+void zith_scan_index_print(const ZithScanIndex *index);
+
+// ============================================================================
+// Construction (parser.cpp, during SCAN)
+// ============================================================================
+
+// Fills 'out' for a top-level declaration spanning [begin, end); false if the
+// node declares nothing the index tracks
+bool scan_index_symbol(ZithNode *decl, ZithSourceLoc begin, ZithSourceLoc end, ZithScanSymbol *out);
+
+// Index over 'symbols' (kept, not copied), allocated in 'arena'
+ZithScanIndex *scan_index_create(ZithArena *arena, ZithNode *program,
+                                 const ZithScanSymbol *symbols, size_t count);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
@@ -18,11 +18,17 @@ extern "C" {
 // Core Types & Utilities
 // ============================================================================
 
+// Posição no source: só o offset em bytes. Linha e coluna são resolvidas
+// quando alguém as vai mostrar (ZithLineIndex)
 typedef struct {
-    size_t index;
-    size_t line;
+    size_t offset;
 } ZithSourceLoc;
 
+typedef struct {
+    size_t line;    // a partir de 1
+    size_t column;  // a partir de 1, em bytes
+} ZithLineCol;
+
 typedef struct {
     const void *data;
     size_t len;
@@ -198,15 +204,132 @@ typedef struct {
     uint16_t keyword_id;
 } ZithToken;
 
+// Valor de um literal numérico, calculado pelo lexer enquanto o valida. Os
+// kinds têm os mesmos valores que ZITH_LIT_INT/UINT/FLOAT
+typedef enum {
+    ZITH_NUMBER_INT = 0,    // decimal até INT64_MAX
+    ZITH_NUMBER_UINT = 1,   // hex/bin/oct, ou decimal acima de INT64_MAX
+    ZITH_NUMBER_FLOAT = 2,
+} ZithNumberKind;
+
+typedef struct {
+    size_t offset;          // loc.offset do token
+    ZithNumberKind kind;
+    union {
+        int64_t i64;
+        uint64_t u64;
+        double f64;
+    } value;
+} ZithNumber;
+
 typedef struct {
     const ZithToken *data;
     size_t len;
+    // data[i].type numa coluna densa (NULL quando ausente): o lookahead do
+    // parser lê daqui sem tocar nos tokens inteiros
+    const uint8_t *types;
+    // Valores dos literais numéricos por offset crescente. Pode faltar (NULL)
+    // ou estar incompleta: um literal sem entrada é convertido a partir do texto
+    const ZithNumber *numbers;
+    size_t number_count;
 } ZithTokenStream;
 
+// Entrada de numbers para o token em 'offset' (busca binária), ou NULL
+const ZithNumber *zith_token_number(const ZithTokenStream *stream, size_t offset);
+
 typedef struct ZithArena ZithArena;
 
+// Offsets do primeiro byte de cada linha, para resolver ZithSourceLoc
+typedef struct {
+    const size_t *starts;  // starts[0] == 0
+    size_t count;
+} ZithLineIndex;
+
+// Uma passagem memchr pelo source; a tabela fica na arena
+bool zith_line_index_build(ZithArena *arena, const char *source, size_t source_len, ZithLineIndex *out);
+
+// Busca binária; um índice vazio resolve tudo para a linha 1
+ZithLineCol zith_line_index_resolve(const ZithLineIndex *index, size_t offset);
+
+// Os lexemas apontam para dentro de source (não são copiados): o buffer tem
+// de viver pelo menos tanto quanto o stream devolvido
 ZithTokenStream zith_tokenize(ZithArena *arena, const char *source, size_t source_len);
 
+// Igual a zith_tokenize, mas fontes grandes (>= 2 MiB) são partidas em
+// quebras de linha fora de strings e comentários e lexadas em 'threads'
+// threads (0 = núcleos disponíveis). Com erros refaz tudo em série, para que
+// o relatório seja o mesmo
+ZithTokenStream zith_tokenize_parallel(ZithArena *arena, const char *source, size_t source_len,
+                                       size_t threads);
+
+// Uma edição: os bytes [start, old_end) do source anterior passaram a ser
+// [start, new_end) do novo
+typedef struct {
+    size_t start;
+    size_t old_end;
+    size_t new_end;
+} ZithSourceEdit;
+
+// Re-lexa só a vizinhança da edição: recomeça no último token que ela não
+// alcança e pára quando os tokens voltam a coincidir com os de prev, que são
+// reaproveitados (deslocados). prev tem de vir de zith_tokenize (ou desta
+// função) sobre o source anterior; com uma edição incoerente lexa tudo
+ZithTokenStream zith_tokenize_incremental(ZithArena *arena, ZithTokenStream prev, ZithSourceEdit edit,
+                                          const char *source, size_t source_len);
+
+// ── Lexer em streaming ──────────────────────────────────────────────────────
+// Puxa tokens um a um de um input lido aos bocados, sem ter o source inteiro
+// em memória: guarda só a janela de bytes que os tokens vivos referem e um
+// anel de tokens. Os offsets (loc) são globais ao input.
+
+// Lê até 'cap' bytes para 'buf'. Devolve quantos leu, 0 no fim do input ou
+// um valor negativo em erro de leitura
+typedef ptrdiff_t (*ZithLexerRead)(void *ctx, char *buf, size_t cap);
+
+typedef struct ZithLexer ZithLexer;
+
+// Maior n aceite por zith_lexer_peek. Um token devolvido (e o seu lexema)
+// continua válido durante pelo menos 2 * ZITH_LEXER_LOOKAHEAD chamadas
+// seguintes a zith_lexer_next
+#define ZITH_LEXER_LOOKAHEAD 16
+
+// chunk_size: bytes pedidos a cada leitura (0 = 64 KiB)
+ZithLexer *zith_lexer_create(ZithLexerRead read, void *ctx, size_t chunk_size);
+ZithLexer *zith_lexer_create_fd(int fd, size_t chunk_size);
+void zith_lexer_destroy(ZithLexer *lexer);
+
+// O próximo token, ou NULL depois de um erro léxico ou de leitura (já
+// reportado). No fim do input devolve sempre o mesmo END
+const ZithToken *zith_lexer_next(ZithLexer *lexer);
+
+// O token n posições à frente do próximo (0 = o próximo), sem o consumir.
+// NULL em erro ou com n >= ZITH_LEXER_LOOKAHEAD
+const ZithToken *zith_lexer_peek(ZithLexer *lexer, size_t n);
+
+bool zith_lexer_failed(const ZithLexer *lexer);
+
+// Forma compacta do stream — tipo, offset e comprimento em colunas paralelas,
+// 9 bytes por token em vez de sizeof(ZithToken). Linha e coluna saem de um
+// ZithLineIndex que só é construído no primeiro pedido.
+typedef struct {
+    const uint8_t *types;        // ZithTokenType
+    const uint32_t *offsets;     // início do lexema em source
+    const uint32_t *lengths;
+    size_t len;
+    const char *source;
+    size_t source_len;
+    ZithArena *arena;            // recebe a tabela de linhas
+    ZithLineIndex lines;         // vazio até ao primeiro zith_token_soa_loc
+} ZithTokenStreamSoA;
+
+// Falha (len == 0, types == NULL) em erro léxico ou com source >= 4 GiB
+ZithTokenStreamSoA zith_tokenize_soa(ZithArena *arena, const char *source, size_t source_len);
+
+ZithLineCol zith_token_soa_loc(ZithTokenStreamSoA *stream, size_t i);
+
+// Reconstrói o token i na forma ZithToken
+ZithToken zith_token_soa_at(const ZithTokenStreamSoA *stream, size_t i);
+
 void zith_debug_tokenize(ZithArena *arena, const char *source, size_t source_len);
 
 // ============================================================================
@@ -298,6 +421,49 @@ ZithNode *zith_parse_with_source(ZithArena *arena, const char *source,
                                          size_t import_root_count = 0);
 #endif
 
+// Lazy parsing: runs SCAN only and leaves every function body as an UNBODY.
+// zith_ast_expand(fn_decl) parses and type-checks one body when it is first
+// needed, so a query costs what it inspects instead of the whole file.
+// Returns NULL on SCAN errors. Not thread-safe: one file's expansions share
+// its arena and diagnostics.
+#ifndef __cplusplus
+ZithNode *zith_parse_lazy(ZithArena *arena, const char *source,
+                                  size_t source_len, const char *filename,
+                                  ZithTokenStream tokens,
+                                  const char **import_roots,
+                                  size_t import_root_count);
+#else
+ZithNode *zith_parse_lazy(ZithArena *arena, const char *source,
+                                  size_t source_len, const char *filename,
+                                  ZithTokenStream tokens,
+                                  const char **import_roots = nullptr,
+                                  size_t import_root_count = 0);
+#endif
+
+// Same as zith_parse_lazy, returning the file's scan index instead: each
+// top-level declaration by name, with its kind, visibility, node and source
+// range (impl/parser/scan_index.hpp). index->program is the lazy tree. Lives
+// in 'arena'; NULL on SCAN errors.
+typedef struct ZithScanIndex ZithScanIndex;
+#ifndef __cplusplus
+const ZithScanIndex *zith_parse_scan(ZithArena *arena, const char *source,
+                                     size_t source_len, const char *filename,
+                                     ZithTokenStream tokens,
+                                     const char **import_roots,
+                                     size_t import_root_count);
+#else
+const ZithScanIndex *zith_parse_scan(ZithArena *arena, const char *source,
+                                     size_t source_len, const char *filename,
+                                     ZithTokenStream tokens,
+                                     const char **import_roots = nullptr,
+                                     size_t import_root_count = 0);
+#endif
+
+// Body of a FUNC_DECL, expanded and checked on the first call for functions
+// from zith_parse_lazy (its diagnostics are printed then). Returns NULL if
+// that expansion reported errors, and on every later call for that function.
+ZithNode *zith_ast_expand(ZithNode *fn_decl);
+
 
 static inline ZithNodeId zith_node_type(const ZithNode *node) {
     return node ? node->type : (ZithNodeId) ZITH_NODE_ERROR;
@@ -309,14 +475,127 @@ static inline ZithNodeId zith_node_type(const ZithNode *node) {
 
 ZithArena *zith_arena_create(size_t initial_block_size);
 
+enum {
+    ZITH_ARENA_HUGE_PAGES = 1u << 0  // 2 MiB-aligned, THP-advised (Linux)
+};
+
+// Reserves 'reserve_bytes' of address space (0 = 1 GiB) and commits it as the
+// arena grows, so everything allocated within the reservation is contiguous.
+// Falls back to a regular arena where reservation is unavailable.
+ZithArena *zith_arena_create_reserved(size_t reserve_bytes, unsigned flags);
+
+bool zith_arena_is_reserved(const ZithArena *arena);
+
+// Aligned to max_align_t
 void *zith_arena_alloc(ZithArena *arena, size_t size);
 
+// 'align' must be a power of two; returns NULL otherwise
+void *zith_arena_alloc_aligned(ZithArena *arena, size_t size, size_t align);
+
+// Grows or shrinks the most recent allocation of the chain, or of the newest
+// large block, in place. Returns false (and changes nothing) if 'ptr' is not
+// such an allocation or the block has no room.
+bool zith_arena_try_extend(ZithArena *arena, void *ptr, size_t old_size, size_t new_size);
+
 char *zith_arena_strdup(ZithArena *arena, const char *str);
 
 void zith_arena_reset(ZithArena *arena);
 
+// Allocation checkpoint. Opaque; only valid for the arena it came from, until
+// that arena is reset or rewound past it. Marks nest LIFO.
+typedef struct {
+    void *block;
+    size_t offset;
+    void *large;
+    size_t used;
+    size_t guards;
+    void *cleanups;
+} ZithArenaMark;
+
+ZithArenaMark zith_arena_mark(const ZithArena *arena);
+
+// Frees everything allocated since 'mark' for reuse
+void zith_arena_rewind(ZithArena *arena, ZithArenaMark mark);
+
+// Calls fn(ctx) when the memory allocated so far is released: on reset,
+// destroy, or a rewind to a mark taken before this call. Newest runs first.
+// Returns false (fn will not be called) if the arena is out of memory.
+bool zith_arena_defer(ZithArena *arena, void (*fn)(void *ctx), void *ctx);
+
+// Releases blocks kept for reuse after a reset back to the system
+void zith_arena_trim(ZithArena *arena);
+
+// Frees every block (pooled arenas hand theirs back to the pool)
 void zith_arena_destroy(ZithArena *arena);
 
+// ZITH_ARENA_DEBUG builds follow every allocation with this many guard bytes
+#ifdef ZITH_ARENA_DEBUG
+#define ZITH_ARENA_GUARD_SIZE 16
+#else
+#define ZITH_ARENA_GUARD_SIZE 0
+#endif
+
+// Number of live allocations whose guard bytes were overwritten. Always 0
+// unless built with ZITH_ARENA_DEBUG, where rewind/reset/destroy also abort
+// on a broken guard.
+size_t zith_arena_check(const ZithArena *arena);
+
+// Bytes handed out (including alignment padding) since the last reset
+size_t zith_arena_used(const ZithArena *arena);
+
+// Allocation sites, only recorded when built with ZITH_ARENA_PROFILE
+typedef enum {
+    ZITH_ARENA_TAG_OTHER = 0,
+    ZITH_ARENA_TAG_TOKENS,
+    ZITH_ARENA_TAG_AST_NODES,
+    ZITH_ARENA_TAG_AST_PAYLOADS,
+    ZITH_ARENA_TAG_DIAGNOSTICS,
+    ZITH_ARENA_TAG_IMPORTS,
+    ZITH_ARENA_TAG_COUNT
+} ZithArenaTag;
+
+typedef struct {
+    size_t requested;     // bytes asked for, cumulative
+    size_t padded;        // alignment padding, cumulative
+    size_t used;          // live bytes since the last reset
+    size_t peak;          // high-water mark of 'used'
+    size_t reserved;      // bytes currently held from the system
+    size_t blocks;        // chain blocks currently held
+    size_t large_allocs;  // allocations that bypassed the chain, cumulative
+    size_t by_tag[ZITH_ARENA_TAG_COUNT];  // requested bytes per site
+} ZithArenaStats;
+
+void zith_arena_get_stats(const ZithArena *arena, ZithArenaStats *out);
+
+// Sets the site charged for following allocations; returns the previous one
+ZithArenaTag zith_arena_set_tag(ZithArena *arena, ZithArenaTag tag);
+
+const char *zith_arena_tag_name(ZithArenaTag tag);
+
+// Moves everything 'src' owns into 'dst': pointers into src stay valid for
+// dst's lifetime (as if allocated in dst now). src is left empty and its marks
+// are invalidated. Neither arena may be in use by another thread.
+void zith_arena_adopt(ZithArena *dst, ZithArena *src);
+
+// ── Arena pool ──────────────────────────────────────────────────────────────
+// Arenas acquired from a pool share a stack of spare chain blocks: a reset or
+// destroy pushes them back with a lock-free CAS, the next block any arena needs
+// pops one under a short spin lock (one popper at a time, so no ABA).
+// The pool is thread-safe; each acquired arena is still single-threaded.
+
+typedef struct ZithArenaPool ZithArenaPool;
+
+ZithArenaPool *zith_arena_pool_create(size_t block_size);
+
+// Every arena acquired from the pool must be destroyed first
+void zith_arena_pool_destroy(ZithArenaPool *pool);
+
+// Destroy with zith_arena_destroy, which hands its blocks back to the pool
+ZithArena *zith_arena_pool_acquire(ZithArenaPool *pool);
+
+// Spare blocks currently in the pool (approximate under contention)
+size_t zith_arena_pool_cached(const ZithArenaPool *pool);
+
 // ============================================================================
 // File Utilities
 // ============================================================================
@@ -329,8 +608,23 @@ size_t zith_file_size(const char *path);
 
 bool zith_file_has_extension(const char *path, const char *ext);
 
+// Copies the file into the arena; the buffer is NUL-terminated
 char *zith_load_file_to_arena(ZithArena *arena, const char *path, size_t *out_size);
 
+// Source text of a file, NUL-terminated. Files of ZITH_SOURCE_MMAP_MIN bytes
+// and up are mapped read-only instead of copied, followed by at least one
+// zero-filled page so the lexer can read past the end. Either way the text
+// lives until the arena is reset, destroyed or rewound past the open.
+typedef struct {
+    const char *data;
+    size_t size;
+    bool mapped;
+} ZithSourceView;
+
+#define ZITH_SOURCE_MMAP_MIN ((size_t) 64 * 1024)
+
+bool zith_source_view_open(ZithArena *arena, const char *path, ZithSourceView *out);
+
 int zith_run(int argc, const char *const argv[]);
 
 ZithTokenType zith_lookup_keyword(const char *src, size_t len);
@@ -358,7 +652,10 @@ typedef enum {
 }
 
 #include <memory>
+#include <new>
 #include <string_view>
+#include <type_traits>
+#include <utility>
 
 namespace ZITH {
     class Arena {
@@ -372,11 +669,36 @@ namespace ZITH {
         explicit Arena(size_t initial = 65536)
             : handle_(zith_arena_create(initial)) { if (!handle_) throw std::bad_alloc(); }
 
+        // Pooled arena: blocks go back to 'pool' when this is destroyed
+        explicit Arena(ZithArenaPool *pool)
+            : handle_(zith_arena_pool_acquire(pool)) { if (!handle_) throw std::bad_alloc(); }
+
         [[nodiscard]] void *alloc(size_t size) const { return zith_arena_alloc(handle_.get(), size); }
+
+        [[nodiscard]] void *alloc(size_t size, size_t align) const {
+            return zith_arena_alloc_aligned(handle_.get(), size, align);
+        }
+
+        // Destructors never run on arena memory, so only trivially
+        // destructible types are accepted
+        template<typename T, typename... Args>
+        [[nodiscard]] T *make(Args &&... args) const {
+            static_assert(std::is_trivially_destructible_v<T>, "arena objects are never destroyed");
+            void *p = alloc(sizeof(T), alignof(T));
+            return p ? new(p) T(std::forward<Args>(args)...) : nullptr;
+        }
+
+        // Uninitialised storage for 'n' objects of T
+        template<typename T>
+        [[nodiscard]] T *alloc_array(size_t n) const {
+            static_assert(std::is_trivially_destructible_v<T>, "arena objects are never destroyed");
+            if (n == 0 || n > SIZE_MAX / sizeof(T)) return nullptr;
+            return static_cast<T *>(alloc(n * sizeof(T), alignof(T)));
+        }
         char *strdup(const char *s) const { return zith_arena_strdup(handle_.get(), s); }
 
         [[nodiscard]] char *strdup(std::string_view sv) const {
-            char *p = static_cast<char *>(alloc(sv.size() + 1));
+            char *p = static_cast<char *>(alloc(sv.size() + 1, 1));
             if (p) {
                 memcpy(p, sv.data(), sv.size());
                 p[sv.size()] = '\0';
@@ -385,6 +707,44 @@ namespace ZITH {
         }
 
         [[nodiscard]] ZithArena *get() const { return handle_.get(); }
+
+        // Rewinds the arena to where it was on construction
+        class Scope {
+            ZithArena *arena_;
+            ZithArenaMark mark_;
+
+        public:
+            explicit Scope(ZithArena *arena) : arena_(arena), mark_(zith_arena_mark(arena)) {}
+            ~Scope() { zith_arena_rewind(arena_, mark_); }
+
+            Scope(const Scope &) = delete;
+            Scope &operator=(const Scope &) = delete;
+        };
+
+        [[nodiscard]] Scope scope() const { return Scope(handle_.get()); }
+
+        [[nodiscard]] size_t used() const { return zith_arena_used(handle_.get()); }
+
+        [[nodiscard]] ZithArenaStats stats() const {
+            ZithArenaStats s;
+            zith_arena_get_stats(handle_.get(), &s);
+            return s;
+        }
+    };
+
+    // Charges allocations in the enclosing scope to 'tag'. Use through
+    // ZITH_ARENA_SITE so non-profiling builds pay nothing.
+    class ArenaTagScope {
+        ZithArena *arena_;
+        ZithArenaTag prev_;
+
+    public:
+        ArenaTagScope(ZithArena *arena, ZithArenaTag tag)
+            : arena_(arena), prev_(zith_arena_set_tag(arena, tag)) {}
+        ~ArenaTagScope() { zith_arena_set_tag(arena_, prev_); }
+
+        ArenaTagScope(const ArenaTagScope &) = delete;
+        ArenaTagScope &operator=(const ArenaTagScope &) = delete;
     };
 
     inline ZithTokenStream tokenize(const Arena &arena, std::string_view source) {
@@ -406,4 +766,10 @@ namespace ZITH {
         void print_ast(const ZithNode *node, int indent = 0);
     }
 } // namespace ZITH
+
+#ifdef ZITH_ARENA_PROFILE
+#define ZITH_ARENA_SITE(arena, tag) const ZITH::ArenaTagScope zith_arena_site_((arena), (tag))
+#else
+#define ZITH_ARENA_SITE(arena, tag) ((void) 0)
+#endif
 #endif // __cplusplus
@@ -0,0 +1,557 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+#include "../impl/memory/arena.hpp"
+#include "../impl/parser/parser.h"
+
+// Allocations sit back to back except for the debug build's guard bytes
+constexpr size_t kGuard = ZITH_ARENA_GUARD_SIZE;
+
+// ============================================================================
+// Block recycling
+// ============================================================================
+
+TEST_CASE("ARENA: reset reuses blocks in allocation order", "[arena]") {
+    ZithArena *arena = zith_arena_create(1024);
+    REQUIRE(arena);
+
+    void *first_pass[16];
+    for (auto &p: first_pass) p = zith_arena_alloc(arena, 200);
+
+    zith_arena_reset(arena);
+
+    for (const auto *expected: first_pass)
+        REQUIRE(zith_arena_alloc(arena, 200) == expected);
+
+    zith_arena_destroy(arena);
+}
+
+TEST_CASE("ARENA: large allocations bypass the block chain", "[arena]") {
+    ZithArena *arena = zith_arena_create(1024);
+    REQUIRE(arena);
+
+    auto *a = static_cast<char *>(zith_arena_alloc(arena, 16));
+    void *big = zith_arena_alloc(arena, 4096);
+    auto *b = static_cast<char *>(zith_arena_alloc(arena, 16));
+
+    REQUIRE(big != nullptr);
+    REQUIRE(b == a + 16 + kGuard);
+
+    zith_arena_destroy(arena);
+}
+
+TEST_CASE("ARENA: retired large blocks are recycled by size class", "[arena]") {
+    ZithArena *arena = zith_arena_create(1024);
+    REQUIRE(arena);
+
+    void *big = zith_arena_alloc(arena, 3000);
+    zith_arena_reset(arena);
+    REQUIRE(zith_arena_alloc(arena, 2500) == big);
+
+    zith_arena_reset(arena);
+    zith_arena_trim(arena);
+    REQUIRE(zith_arena_alloc(arena, 16) != nullptr);
+
+    zith_arena_destroy(arena);
+}
+
+// ============================================================================
+// Aligned allocation
+// ============================================================================
+
+TEST_CASE("ARENA: aligned allocation honours the requested alignment", "[arena]") {
+    ZithArena *arena = zith_arena_create(1024);
+    REQUIRE(arena);
+
+    auto *c = static_cast<char *>(zith_arena_alloc_aligned(arena, 1, 1));
+    auto *d = static_cast<char *>(zith_arena_alloc_aligned(arena, 3, 1));
+    REQUIRE(d == c + 1 + kGuard);
+
+    for (const size_t align: {2u, 8u, 32u, 64u}) {
+        void *p = zith_arena_alloc_aligned(arena, 5, align);
+        REQUIRE(reinterpret_cast<uintptr_t>(p) % align == 0);
+    }
+
+    void *big = zith_arena_alloc_aligned(arena, 4096, 64);
+    REQUIRE(reinterpret_cast<uintptr_t>(big) % 64 == 0);
+
+    REQUIRE(zith_arena_alloc_aligned(arena, 8, 3) == nullptr);
+    REQUIRE(zith_arena_alloc_aligned(arena, 8, 0) == nullptr);
+
+    zith_arena_destroy(arena);
+}
+
+TEST_CASE("ARENA: typed helpers construct at alignof(T)", "[arena]") {
+    struct alignas(32) Wide {
+        int a;
+        int b;
+    };
+
+    const ZITH::Arena arena(1024);
+    (void) arena.alloc(1, 1);
+
+    const Wide *w = arena.make<Wide>(Wide{1, 2});
+    REQUIRE(w != nullptr);
+    REQUIRE(reinterpret_cast<uintptr_t>(w) % alignof(Wide) == 0);
+    REQUIRE(w->a == 1);
+    REQUIRE(w->b == 2);
+
+    auto *xs = arena.alloc_array<uint64_t>(10);
+    REQUIRE(xs != nullptr);
+    REQUIRE(reinterpret_cast<uintptr_t>(xs) % alignof(uint64_t) == 0);
+    REQUIRE(arena.alloc_array<uint64_t>(0) == nullptr);
+}
+
+// ============================================================================
+// Checkpoints
+// ============================================================================
+
+TEST_CASE("ARENA: rewind reclaims everything since the mark", "[arena]") {
+    ZithArena *arena = zith_arena_create(1024);
+    REQUIRE(arena);
+
+    auto *keep = static_cast<char *>(zith_arena_alloc(arena, 16));
+    keep[0] = 'k';
+    const ZithArenaMark mark = zith_arena_mark(arena);
+    void *after_mark = zith_arena_alloc(arena, 16);
+
+    // Cross several block boundaries and take a large block
+    for (int i = 0; i < 20; ++i) (void) zith_arena_alloc(arena, 200);
+    void *big = zith_arena_alloc(arena, 3000);
+
+    zith_arena_rewind(arena, mark);
+    REQUIRE(zith_arena_alloc(arena, 16) == after_mark);
+    REQUIRE(zith_arena_alloc(arena, 3000) == big);
+    REQUIRE(keep[0] == 'k');
+
+    zith_arena_destroy(arena);
+}
+
+TEST_CASE("ARENA: marks nest and a mark on an empty arena rewinds to the start", "[arena]") {
+    ZithArena *arena = zith_arena_create(1024);
+    REQUIRE(arena);
+
+    const ZithArenaMark outer = zith_arena_mark(arena);
+    void *first = zith_arena_alloc(arena, 32);
+
+    const ZithArenaMark inner = zith_arena_mark(arena);
+    void *second = zith_arena_alloc(arena, 32);
+    zith_arena_rewind(arena, inner);
+    REQUIRE(zith_arena_alloc(arena, 32) == second);
+
+    zith_arena_rewind(arena, outer);
+    REQUIRE(zith_arena_alloc(arena, 32) == first);
+
+    zith_arena_destroy(arena);
+}
+
+TEST_CASE("ARENA: Scope guard rewinds on exit", "[arena]") {
+    const ZITH::Arena arena(1024);
+    void *before = nullptr;
+    {
+        const auto scope = arena.scope();
+        before = arena.alloc(64);
+        for (int i = 0; i < 10; ++i) (void) arena.alloc(200);
+    }
+    REQUIRE(arena.alloc(64) == before);
+}
+
+// ============================================================================
+// Statistics
+// ============================================================================
+
+TEST_CASE("ARENA: stats track requests, padding, peak and rewinds", "[arena]") {
+    ZithArena *arena = zith_arena_create(1024);
+    REQUIRE(arena);
+
+    (void) zith_arena_alloc_aligned(arena, 3, 1);
+    (void) zith_arena_alloc_aligned(arena, 8, 8);  // 5 bytes of padding
+
+    ZithArenaStats s;
+    zith_arena_get_stats(arena, &s);
+    const size_t small = 16 + 2 * kGuard;  // guard bytes count as padding
+    REQUIRE(s.requested == 11);
+    REQUIRE(s.padded == 5 + 2 * kGuard);
+    REQUIRE(s.used == small);
+    REQUIRE(zith_arena_used(arena) == small);
+    REQUIRE(s.blocks == 1);
+
+    const ZithArenaMark mark = zith_arena_mark(arena);
+    (void) zith_arena_alloc_aligned(arena, 4096, 8);
+    zith_arena_get_stats(arena, &s);
+    REQUIRE(s.large_allocs == 1);
+    REQUIRE(s.used == small + 4096 + kGuard);
+
+    zith_arena_rewind(arena, mark);
+    zith_arena_get_stats(arena, &s);
+    REQUIRE(s.used == small);
+    REQUIRE(s.peak == small + 4096 + kGuard);
+
+    zith_arena_reset(arena);
+    REQUIRE(zith_arena_used(arena) == 0);
+
+    zith_arena_destroy(arena);
+}
+
+// ============================================================================
+// Pool and ownership transfer
+// ============================================================================
+
+TEST_CASE("ARENA: pooled arenas return blocks to the pool", "[arena][pool]") {
+    ZithArenaPool *pool = zith_arena_pool_create(1024);
+    REQUIRE(pool);
+
+    ZithArena *a = zith_arena_pool_acquire(pool);
+    for (int i = 0; i < 16; ++i) (void) zith_arena_alloc(a, 200);
+    zith_arena_reset(a);
+    const size_t after_reset = zith_arena_pool_cached(pool);
+    REQUIRE(after_reset > 0);
+
+    // A second arena refills from the pool instead of malloc
+    ZithArena *b = zith_arena_pool_acquire(pool);
+    (void) zith_arena_alloc(b, 200);
+    REQUIRE(zith_arena_pool_cached(pool) == after_reset - 1);
+
+    zith_arena_destroy(a);
+    zith_arena_destroy(b);
+    REQUIRE(zith_arena_pool_cached(pool) == after_reset + 1);
+
+    zith_arena_pool_destroy(pool);
+}
+
+TEST_CASE("ARENA: pool is safe to share between threads", "[arena][pool]") {
+    ZithArenaPool *pool = zith_arena_pool_create(4096);
+    REQUIRE(pool);
+
+    constexpr int kThreads = 8;
+    std::vector<std::thread> workers;
+    std::vector<int> ok(kThreads, 1);
+    for (int t = 0; t < kThreads; ++t) {
+        workers.emplace_back([pool, t, &ok] {
+            for (int round = 0; round < 200; ++round) {
+                ZithArena *arena = zith_arena_pool_acquire(pool);
+                std::vector<unsigned char *> ptrs;
+                for (int i = 0; i < 64; ++i) {
+                    auto *p = static_cast<unsigned char *>(zith_arena_alloc(arena, 256));
+                    std::memset(p, t, 256);
+                    ptrs.push_back(p);
+                }
+                for (const auto *p: ptrs)
+                    if (p[0] != t || p[255] != t) ok[t] = 0;
+                zith_arena_destroy(arena);
+            }
+        });
+    }
+    for (auto &w: workers) w.join();
+
+    for (const int v: ok) REQUIRE(v == 1);
+    zith_arena_pool_destroy(pool);
+}
+
+TEST_CASE("ARENA: adopt moves live allocations to another arena", "[arena]") {
+    ZithArena *dst = zith_arena_create(1024);
+    ZithArena *src = zith_arena_create(1024);
+
+    auto *small = static_cast<char *>(zith_arena_alloc(src, 6));
+    std::memcpy(small, "hello", 6);
+    auto *big = static_cast<char *>(zith_arena_alloc(src, 5000));
+    std::memset(big, 'x', 5000);
+    const size_t src_used = zith_arena_used(src);
+
+    zith_arena_adopt(dst, src);
+    REQUIRE(zith_arena_used(src) == 0);
+    REQUIRE(zith_arena_used(dst) == src_used);
+
+    // src is reusable and no longer shares storage with what it gave away
+    auto *again = static_cast<char *>(zith_arena_alloc(src, 6));
+    std::memcpy(again, "world", 6);
+    zith_arena_destroy(src);
+
+    REQUIRE(std::strcmp(small, "hello") == 0);
+    REQUIRE(big[4999] == 'x');
+
+    zith_arena_destroy(dst);
+}
+
+// ============================================================================
+// Reserved (virtual memory) backend
+// ============================================================================
+
+TEST_CASE("ARENA: reserved arena stays contiguous past the commit step", "[arena][vm]") {
+    ZithArena *arena = zith_arena_create_reserved(64u << 20, 0);
+    REQUIRE(arena);
+    if (!zith_arena_is_reserved(arena)) {
+        zith_arena_destroy(arena);
+        SUCCEED("virtual memory reservation unavailable on this platform");
+        return;
+    }
+
+    // Small and large requests alike come from one growing range
+    auto *first = static_cast<char *>(zith_arena_alloc_aligned(arena, 100, 1));
+    auto *big = static_cast<char *>(zith_arena_alloc_aligned(arena, 1u << 20, 1));
+    auto *after = static_cast<char *>(zith_arena_alloc_aligned(arena, 100, 1));
+    REQUIRE(big == first + 100 + kGuard);
+    REQUIRE(after == big + (1u << 20) + kGuard);
+
+    std::memset(big, 0xAB, 1u << 20);
+    REQUIRE(static_cast<unsigned char>(big[(1u << 20) - 1]) == 0xAB);
+
+    ZithArenaStats s;
+    zith_arena_get_stats(arena, &s);
+    REQUIRE(s.large_allocs == 0);
+    REQUIRE(s.blocks == 1);
+
+    zith_arena_reset(arena);
+    zith_arena_trim(arena);
+    zith_arena_get_stats(arena, &s);
+    REQUIRE(s.reserved < (1u << 20));
+    REQUIRE(zith_arena_alloc_aligned(arena, 100, 1) == first);
+
+    zith_arena_destroy(arena);
+}
+
+TEST_CASE("ARENA: reserved arena falls back to heap blocks when exhausted", "[arena][vm]") {
+    ZithArena *arena = zith_arena_create_reserved(128u << 10, ZITH_ARENA_HUGE_PAGES);
+    REQUIRE(arena);
+
+    for (int i = 0; i < 64; ++i) {
+        auto *p = static_cast<char *>(zith_arena_alloc(arena, 60000));
+        REQUIRE(p != nullptr);
+        p[0] = p[59999] = static_cast<char>(i);
+    }
+
+    zith_arena_destroy(arena);
+}
+
+// ============================================================================
+// In-place extension and ArenaList
+// ============================================================================
+
+TEST_CASE("ARENA: try_extend grows and shrinks only the latest allocation", "[arena]") {
+    ZithArena *arena = zith_arena_create(1024);
+    REQUIRE(arena);
+
+    auto *a = static_cast<char *>(zith_arena_alloc_aligned(arena, 16, 1));
+    auto *b = static_cast<char *>(zith_arena_alloc_aligned(arena, 16, 1));
+    REQUIRE_FALSE(zith_arena_try_extend(arena, a, 16, 32));
+    REQUIRE(zith_arena_try_extend(arena, b, 16, 64));
+    REQUIRE(zith_arena_alloc_aligned(arena, 1, 1) == b + 64 + kGuard);
+    REQUIRE(zith_arena_used(arena) == 16 + 64 + 1 + 3 * kGuard);
+
+    auto *c = static_cast<char *>(zith_arena_alloc_aligned(arena, 100, 1));
+    REQUIRE(zith_arena_try_extend(arena, c, 100, 10));
+    REQUIRE(zith_arena_alloc_aligned(arena, 1, 1) == c + 10 + kGuard);
+
+    // No room left in the block
+    auto *d = static_cast<char *>(zith_arena_alloc_aligned(arena, 8, 1));
+    REQUIRE_FALSE(zith_arena_try_extend(arena, d, 8, 4096));
+
+    zith_arena_destroy(arena);
+}
+
+TEST_CASE("ARENA: ArenaList hands back a single chunk without copying", "[arena]") {
+    ZithArena *arena = zith_arena_create(64 * 1024);
+    REQUIRE(arena);
+
+    zith::ArenaList<int> list;
+    list.init(arena, 4);
+    for (int i = 0; i < 1000; ++i) list.push(arena, i);
+
+    // Nothing else was allocated, so the tail chunk kept growing in place
+    const int *first = list.at(0);
+    size_t count = 0;
+    const int *items = list.take_contiguous(arena, &count);
+    REQUIRE(count == 1000);
+    REQUIRE(items == first);
+    for (int i = 0; i < 1000; ++i) REQUIRE(items[i] == i);
+
+    // Unused capacity went back to the arena
+    const auto *next = static_cast<const char *>(zith_arena_alloc_aligned(arena, 1, 1));
+    REQUIRE(next == reinterpret_cast<const char *>(items + count) + kGuard);
+
+    zith_arena_destroy(arena);
+}
+
+TEST_CASE("ARENA: ArenaList interleaved with other allocations still flattens", "[arena]") {
+    ZithArena *arena = zith_arena_create(64 * 1024);
+    REQUIRE(arena);
+
+    zith::ArenaList<int> list;
+    list.init(arena, 4);
+    for (int i = 0; i < 1000; ++i) {
+        list.push(arena, i);
+        (void) zith_arena_alloc(arena, 8);
+    }
+
+    size_t count = 0;
+    const int *items = list.take_contiguous(arena, &count);
+    REQUIRE(count == 1000);
+    for (int i = 0; i < 1000; ++i) REQUIRE(items[i] == i);
+
+    zith_arena_destroy(arena);
+}
+
+// ============================================================================
+// Deferred cleanups and source views
+// ============================================================================
+
+TEST_CASE("ARENA: deferred cleanups run on rewind, reset and destroy", "[arena]") {
+    ZithArena *arena = zith_arena_create(1024);
+    std::vector<int> ran;
+    auto push = [](void *ctx) {
+        auto *slot = static_cast<std::pair<std::vector<int> *, int> *>(ctx);
+        slot->first->push_back(slot->second);
+    };
+    std::pair<std::vector<int> *, int> a{&ran, 1}, b{&ran, 2}, c{&ran, 3}, d{&ran, 4};
+
+    REQUIRE(zith_arena_defer(arena, push, &a));
+    const ZithArenaMark mark = zith_arena_mark(arena);
+    REQUIRE(zith_arena_defer(arena, push, &b));
+    REQUIRE(zith_arena_defer(arena, push, &c));
+    zith_arena_rewind(arena, mark);
+    REQUIRE(ran == std::vector<int>{3, 2});
+
+    zith_arena_reset(arena);
+    REQUIRE(ran == std::vector<int>{3, 2, 1});
+
+    REQUIRE(zith_arena_defer(arena, push, &d));
+    zith_arena_destroy(arena);
+    REQUIRE(ran == std::vector<int>{3, 2, 1, 4});
+}
+
+TEST_CASE("ARENA: source views are NUL-terminated, mapped when large", "[arena]") {
+    const auto dir = std::filesystem::temp_directory_path();
+    const auto small_path = (dir / "zith_view_small.zith").string();
+    const auto large_path = (dir / "zith_view_large.zith").string();
+
+    // Exactly a multiple of the page size: the sentinel page supplies the NUL
+    const std::string large(ZITH_SOURCE_MMAP_MIN * 2, 'x');
+    std::ofstream(small_path, std::ios::binary) << "fn main() {}";
+    std::ofstream(large_path, std::ios::binary) << large;
+
+    ZithArena *arena = zith_arena_create(1024);
+    ZithSourceView view;
+
+    REQUIRE(zith_source_view_open(arena, small_path.c_str(), &view));
+    REQUIRE_FALSE(view.mapped);
+    REQUIRE(view.size == 12);
+    REQUIRE(view.data[view.size] == '\0');
+
+    const ZithArenaMark mark = zith_arena_mark(arena);
+    REQUIRE(zith_source_view_open(arena, large_path.c_str(), &view));
+#ifndef _WIN32
+    REQUIRE(view.mapped);
+#endif
+    REQUIRE(view.size == large.size());
+    REQUIRE(view.data[0] == 'x');
+    REQUIRE(view.data[view.size - 1] == 'x');
+    REQUIRE(view.data[view.size] == '\0');
+    zith_arena_rewind(arena, mark);
+
+    size_t size = 0;
+    const char *copy = zith_load_file_to_arena(arena, large_path.c_str(), &size);
+    REQUIRE(copy != nullptr);
+    REQUIRE(size == large.size());
+    REQUIRE(copy[size] == '\0');
+
+    // Passes the extension check, fails as a non-regular file
+    const auto dir_path = (dir / "zith_view_dir.zith").string();
+    std::filesystem::create_directory(dir_path);
+    REQUIRE_FALSE(zith_source_view_open(arena, dir_path.c_str(), &view));
+
+    zith_arena_destroy(arena);
+    std::filesystem::remove(small_path);
+    std::filesystem::remove(large_path);
+    std::filesystem::remove(dir_path);
+}
+
+// ============================================================================
+// Leak checks
+// ============================================================================
+
+TEST_CASE("ARENA: destroy returns every block to the system", "[arena]") {
+    // Chain blocks, dedicated blocks and recycled ones all go back
+    for (int round = 0; round < 4; ++round) {
+        ZithArena *arena = zith_arena_create(1024);
+        for (int i = 0; i < 32; ++i) (void) zith_arena_alloc(arena, 200);
+        (void) zith_arena_alloc(arena, 3000);
+        zith_arena_reset(arena);
+        (void) zith_arena_alloc(arena, 100);
+        REQUIRE(zith_arena_check(arena) == 0);
+        zith_arena_destroy(arena);
+    }
+}
+
+// Under ASan the overflowing write itself is reported, so only plain debug
+// builds exercise the guard check
+#if defined(ZITH_ARENA_DEBUG) && !defined(__SANITIZE_ADDRESS__)
+TEST_CASE("ARENA: debug guards catch writes past an allocation", "[arena]") {
+    ZithArena *arena = zith_arena_create(1024);
+    auto *p = static_cast<char *>(zith_arena_alloc_aligned(arena, 8, 1));
+    REQUIRE(zith_arena_check(arena) == 0);
+
+    const char saved = p[8];
+    p[8] = 'x';
+    REQUIRE(zith_arena_check(arena) == 1);
+    p[8] = saved;
+
+    zith_arena_destroy(arena);
+}
+#endif
+
+// Only the RSS test below uses it, and ASan builds skip that test
+#if defined(__linux__) && !defined(__SANITIZE_ADDRESS__)
+static size_t resident_bytes() {
+    size_t pages = 0, resident = 0;
+    FILE *f = std::fopen("/proc/self/statm", "r");
+    if (!f) return 0;
+    if (std::fscanf(f, "%zu %zu", &pages, &resident) != 2) resident = 0;
+    std::fclose(f);
+    return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+#endif
+
+TEST_CASE("ARENA: RSS stays flat over repeated parse cycles", "[arena][rss]") {
+#if !defined(__linux__)
+    SUCCEED("RSS is only sampled on Linux");
+#elif defined(__SANITIZE_ADDRESS__)
+    SUCCEED("ASan quarantines freed blocks, so RSS is not meaningful");
+#else
+    std::string source;
+    for (int i = 0; i < 40; ++i)
+        source += "fn f" + std::to_string(i) + "(a: i32, b: i32) -> i32 { let c = a * b + " +
+                  std::to_string(i) + "; return c; }\n";
+
+    // One fresh arena per cycle, as the driver does per file
+    auto cycle = [&source] {
+        ZithArena *arena = zith_arena_create(4096);
+        const ZithTokenStream tokens = zith_tokenize(arena, source.data(), source.size());
+        REQUIRE(tokens.data != nullptr);
+        zith_arena_destroy(arena);
+        REQUIRE(parse_test(source.c_str()));
+    };
+
+    for (int i = 0; i < 1000; ++i) cycle();
+    const size_t before = resident_bytes();
+    if (before == 0) {
+        SUCCEED("/proc/self/statm unavailable");
+        return;
+    }
+    for (int i = 0; i < 9000; ++i) cycle();
+    const size_t after = resident_bytes();
+
+    // A single leaked block per cycle would already be ~36 MiB
+    REQUIRE(after < before + (4u << 20));
+#endif
+}
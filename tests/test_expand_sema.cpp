@@ -3,6 +3,10 @@
 #include "../impl/parser/parser.h"
 #include "../impl/ast/ast.h"
 
+#include <algorithm>
+#include <string>
+#include <vector>
+
 TEST_CASE("FULL: function body is expanded into BLOCK", "[full][expand]") {
     auto ast = ParseResult(zith_parse_test_full(
         "fn main() -> i32 {\n"
@@ -29,6 +33,162 @@ TEST_CASE("FULL: function body is expanded into BLOCK", "[full][expand]") {
     REQUIRE(stmts[2]->type == ZITH_NODE_FOR);
 }
 
+TEST_CASE("FULL: bodies expand in place from the scanned token stream", "[full][expand]") {
+    auto ast = ParseResult(zith_parse_test_full(
+        "fn a() -> i32 { return 0x10; }\n"
+        "fn b() -> i32 { let y: i32 = 2'000; if (y < 3) { return 1; } return y; }\n"
+    ));
+    REQUIRE(ast);
+    REQUIRE(ast->data.list.len == 2);
+
+    auto **decls = static_cast<ZithNode **>(ast->data.list.ptr);
+    auto *a = static_cast<ZithFuncPayload *>(decls[0]->data.list.ptr);
+    auto *b = static_cast<ZithFuncPayload *>(decls[1]->data.list.ptr);
+    REQUIRE(a->body->type == ZITH_NODE_BLOCK);
+    REQUIRE(b->body->type == ZITH_NODE_BLOCK);
+    REQUIRE(a->body->data.list.len == 1);
+    REQUIRE(b->body->data.list.len == 3);
+
+    // Each body stops at its own slice end, not at the next function
+    auto **a_stmts = static_cast<ZithNode **>(a->body->data.list.ptr);
+    REQUIRE(a_stmts[0]->type == ZITH_NODE_RETURN);
+    const ZithNode *lit = a_stmts[0]->data.kids.a;
+    REQUIRE(lit->type == ZITH_NODE_LITERAL);
+    REQUIRE(static_cast<const ZithLiteral *>(lit->data.list.ptr)->value.u64 == 16);
+}
+
+// SCAN 'src' into its own arena and expand it with 'threads' workers
+static ZithNode *scan_and_expand(ZithArena *arena, const std::string &src, size_t threads, Parser *p) {
+    ZithTokenStream tokens = zith_tokenize(arena, src.data(), src.size());
+    REQUIRE(tokens.data);
+    parser_init(p, arena, src.data(), src.size(), "<test>", tokens);
+    p->mode = ZITH_MODE_SCAN;
+
+    std::vector<ZithNode *> decls;
+    while (!parser_is_at_end(p)) {
+        const size_t before = p->pos;
+        if (ZithNode *decl = parser_parse_declaration(p)) decls.push_back(decl);
+        if (p->pos == before && !parser_is_at_end(p)) parser_advance(p);
+    }
+    auto **items = static_cast<ZithNode **>(zith_arena_alloc(arena, decls.size() * sizeof(ZithNode *)));
+    std::copy(decls.begin(), decls.end(), items);
+    return parser_expand(p, zith_ast_make_program(arena, items, decls.size()), threads);
+}
+
+TEST_CASE("EXPAND: parallel expansion matches serial, diagnostics in source order", "[expand][parallel]") {
+    std::string src;
+    for (int i = 0; i < 400; ++i) {
+        src += "fn body_" + std::to_string(i) + "() -> i32 {\n";
+        src += "  let v: i32 = " + std::to_string(i) + ";\n";
+        if (i % 7 == 0) src += "  let = ;\n";
+        src += "  if (v < 3) { return 1; }\n";
+        src += "  return v;\n}\n";
+    }
+
+    ZithArena *serial_arena = zith_arena_create(0);
+    ZithArena *parallel_arena = zith_arena_create(0);
+    Parser serial{}, parallel{};
+    ZithNode *a = scan_and_expand(serial_arena, src, 1, &serial);
+    ZithNode *b = scan_and_expand(parallel_arena, src, 4, &parallel);
+
+    REQUIRE(a->data.list.len == 400);
+    REQUIRE(b->data.list.len == 400);
+    auto **da = static_cast<ZithNode **>(a->data.list.ptr);
+    auto **db = static_cast<ZithNode **>(b->data.list.ptr);
+    for (size_t i = 0; i < 400; ++i) {
+        auto *fa = static_cast<ZithFuncPayload *>(da[i]->data.list.ptr);
+        auto *fb = static_cast<ZithFuncPayload *>(db[i]->data.list.ptr);
+        REQUIRE(fb->body->type == ZITH_NODE_BLOCK);
+        REQUIRE(fb->body->data.list.len == fa->body->data.list.len);
+        auto **sa = static_cast<ZithNode **>(fa->body->data.list.ptr);
+        auto **sb = static_cast<ZithNode **>(fb->body->data.list.ptr);
+        for (size_t k = 0; k < fa->body->data.list.len; ++k)
+            REQUIRE(sb[k]->type == sa[k]->type);
+    }
+
+    REQUIRE(serial.had_error);
+    REQUIRE(parallel.had_error);
+    REQUIRE(serial.diags.count > 0);
+    REQUIRE(parallel.diags.count == serial.diags.count);
+    for (size_t k = 0; k < serial.diags.count; ++k) {
+        REQUIRE(parallel.diags.items[k].loc.offset == serial.diags.items[k].loc.offset);
+        REQUIRE(std::string(parallel.diags.items[k].message) == serial.diags.items[k].message);
+        if (k) REQUIRE(parallel.diags.items[k - 1].loc.offset <= parallel.diags.items[k].loc.offset);
+    }
+
+    zith_arena_destroy(serial_arena);
+    zith_arena_destroy(parallel_arena);
+}
+
+TEST_CASE("LAZY: bodies expand only when asked for", "[lazy][expand]") {
+    const std::string src =
+        "fn a() -> i32 { return 1; }\n"
+        "fn b() -> i32 { let s: str = \"x\"; return s; }\n"
+        "fn c() -> i32 { return a(); }\n";
+
+    ZithArena *arena = zith_arena_create(0);
+    ZithTokenStream tokens = zith_tokenize(arena, src.data(), src.size());
+    ZithNode *root = zith_parse_lazy(arena, src.data(), src.size(), "<test>", tokens);
+    REQUIRE(root);
+    REQUIRE(root->data.list.len == 3);
+
+    auto **decls = static_cast<ZithNode **>(root->data.list.ptr);
+    auto body = [&](size_t i) { return static_cast<ZithFuncPayload *>(decls[i]->data.list.ptr)->body; };
+    for (size_t i = 0; i < 3; ++i) REQUIRE(body(i)->type == ZITH_NODE_UNBODY);
+
+    // Expanding one function leaves the others alone
+    ZithNode *c = zith_ast_expand(decls[2]);
+    REQUIRE(c);
+    REQUIRE(c->type == ZITH_NODE_BLOCK);
+    REQUIRE(c == body(2));
+    REQUIRE(body(0)->type == ZITH_NODE_UNBODY);
+    REQUIRE(body(1)->type == ZITH_NODE_UNBODY);
+    REQUIRE(zith_ast_expand(decls[2]) == c);
+
+    // Sema runs on the expanded body only
+    REQUIRE_FALSE(zith_ast_expand(decls[1]));
+    REQUIRE(body(1)->type == ZITH_NODE_BLOCK);
+    REQUIRE_FALSE(zith_ast_expand(decls[1]));
+    REQUIRE(body(0)->type == ZITH_NODE_UNBODY);
+
+    zith_arena_destroy(arena);
+}
+
+TEST_CASE("SCAN: index maps top-level names to declarations", "[scan][index]") {
+    const std::string src =
+        "import std/io;\n"
+        "struct Point { x: i32, }\n"
+        "public fn area() -> i32 { return 1; }\n"
+        "fn main() { }\n";
+
+    ZithArena *arena = zith_arena_create(0);
+    ZithTokenStream tokens = zith_tokenize(arena, src.data(), src.size());
+    const ZithScanIndex *index = zith_parse_scan(arena, src.data(), src.size(), "<test>", tokens);
+    REQUIRE(index);
+    REQUIRE(index->program->type == ZITH_NODE_PROGRAM);
+    REQUIRE(index->count == 4);
+    REQUIRE(index->symbols[0].kind == ZITH_SCAN_IMPORT);
+    REQUIRE(index->symbols[1].kind == ZITH_SCAN_STRUCT);
+
+    const ZithScanSymbol *area = zith_scan_index_find(index, "area", 4);
+    REQUIRE(area);
+    REQUIRE(area->kind == ZITH_SCAN_FN);
+    REQUIRE(area->visibility == ZITH_VIS_PUBLIC);
+    REQUIRE(area->decl == static_cast<ZithNode **>(index->program->data.list.ptr)[2]);
+    REQUIRE(src.substr(area->begin.offset, area->end.offset - area->begin.offset) ==
+            "public fn area() -> i32 { return 1; }");
+
+    const ZithScanSymbol *io = zith_scan_index_find(index, "std/io", 6);
+    REQUIRE(io);
+    REQUIRE(io->kind == ZITH_SCAN_IMPORT);
+    REQUIRE_FALSE(zith_scan_index_find(index, "missing", 7));
+
+    // The declarations are the lazy tree's: bodies expand on demand
+    REQUIRE(zith_ast_expand(area->decl));
+
+    zith_arena_destroy(arena);
+}
+
 TEST_CASE("FULL: optional/failable assignment is consistent", "[full][sema][types]") {
     auto ok = ParseResult(zith_parse_test_full(
         "fn main() {\n"
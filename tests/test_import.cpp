@@ -1,5 +1,13 @@
 #include <catch2/catch_test_macros.hpp>
 
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <thread>
+#include <vector>
+
 #include "../impl/parser/parser.h"
 #include "../impl/ast/ast.h"
 
@@ -63,4 +71,104 @@ TEST_CASE("IMPORT: mixed import and export", "[import][scan]") {
 TEST_CASE("IMPORT: import with semicolon required", "[import][scan][error]") {
     auto ast = ParseResult(zith_parse_test("import std/io"));
     (void)ast;
-}
\ No newline at end of file
+}
+
+// ============================================================================
+// Prefetch
+// ============================================================================
+
+// Runs the body inside a fresh scratch project directory with std/io.zith
+// and std/math.zith, restoring the working directory afterwards. The name is
+// unique so test processes run in parallel (ctest -j) never share one.
+struct ScratchProject {
+    std::filesystem::path previous = std::filesystem::current_path();
+    std::filesystem::path dir;
+
+    ScratchProject() {
+        std::random_device rd;
+        do {
+            char name[48];
+            std::snprintf(name, sizeof(name), "zith_prefetch_test_%08x%08x", rd(), rd());
+            dir = std::filesystem::temp_directory_path() / name;
+        } while (!std::filesystem::create_directory(dir));
+        std::filesystem::create_directories(dir / "std");
+        std::ofstream(dir / "std" / "io.zith") << "pub fn println(s: string): void { let x = 1; }\n";
+        std::ofstream(dir / "std" / "math.zith") << "pub fn add(a: i32, b: i32): i32 { return a + b; }\n";
+        std::filesystem::current_path(dir);
+    }
+    ~ScratchProject() {
+        std::filesystem::current_path(previous);
+        std::filesystem::remove_all(dir);
+    }
+};
+
+TEST_CASE("IMPORT: prefetch loads every top-level import up front", "[import][prefetch]") {
+    const ScratchProject project;
+    const char *src =
+        "import std/io;\n"
+        "import std.math;\n"
+        "import std/io;\n"
+        "import std/missing;\n"
+        "from std/hidden import x;\n"
+        "fn main(): i32 { return 0; }\n";
+    const char *roots[] = {"std"};
+
+    ZithArena *arena = zith_arena_create(0);
+    const ZithTokenStream tokens = zith_tokenize(arena, src, strlen(src));
+    Parser p;
+    parser_init(&p, arena, src, strlen(src), "main.zith", tokens);
+    parser_set_import_roots(&p, roots, 1);
+    parser_prefetch_imports(&p);
+
+    ZithSourceView view;
+    REQUIRE(parser_prefetched_source(&p, "std/io.zith", &view) == PrefetchResult::Loaded);
+    REQUIRE(std::strstr(view.data, "println") != nullptr);
+    REQUIRE(parser_prefetched_source(&p, "std/math.zith", &view) == PrefetchResult::Loaded);
+    REQUIRE(parser_prefetched_source(&p, "std/missing.zith", &view) == PrefetchResult::Failed);
+    REQUIRE(parser_prefetched_source(&p, "std/hidden.zith", &view) == PrefetchResult::NotPrefetched);
+
+    parser_prefetch_release(&p);
+    REQUIRE(parser_prefetched_source(&p, "std/io.zith", &view) == PrefetchResult::NotPrefetched);
+    zith_arena_destroy(arena);
+}
+
+TEST_CASE("IMPORT: prefetched modules feed SCAN", "[import][prefetch]") {
+    const ScratchProject project;
+    const char *src =
+        "import std/io;\n"
+        "import std/math;\n"
+        "fn main(): i32 { let y = add(1, 2); return 0; }\n";
+    const char *roots[] = {"std"};
+
+    ZithArena *arena = zith_arena_create(0);
+    const ZithTokenStream tokens = zith_tokenize(arena, src, strlen(src));
+    REQUIRE(zith_parse_with_source(arena, src, strlen(src), "main.zith", tokens, roots, 1) != nullptr);
+    zith_arena_destroy(arena);
+}
+
+TEST_CASE("IMPORT: concurrent parses keep their imports apart", "[import][concurrency]") {
+    const ScratchProject project;
+    // Only 'with' may call add(): it must not leak into the other parse
+    const char *with = "import std/math;\nfn main(): i32 { let y = add(1, 2); return 0; }\n";
+    const char *without = "fn main(): i32 { let y = add(1, 2); return 0; }\n";
+    const char *roots[] = {"std"};
+
+    constexpr int kThreads = 8, kRounds = 16;
+    std::vector<int> wrong(kThreads, 0);
+    std::vector<std::thread> pool;
+    for (int t = 0; t < kThreads; ++t) {
+        pool.emplace_back([&, t] {
+            for (int r = 0; r < kRounds; ++r) {
+                const bool imports = (t + r) % 2 == 0;
+                const char *src = imports ? with : without;
+                ZithArena *arena = zith_arena_create(0);
+                const ZithTokenStream tokens = zith_tokenize(arena, src, strlen(src));
+                const bool ok = zith_parse_with_source(arena, src, strlen(src), "main.zith", tokens, roots, 1) != nullptr;
+                if (ok != imports) ++wrong[t];
+                zith_arena_destroy(arena);
+            }
+        });
+    }
+    for (auto &th: pool) th.join();
+    for (int t = 0; t < kThreads; ++t) REQUIRE(wrong[t] == 0);
+}
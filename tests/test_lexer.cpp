@@ -0,0 +1,513 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "../impl/lexer/punctuation.hpp"
+#include "../impl/lexer/scan.hpp"
+#include "../impl/memory/arena.hpp"
+
+namespace scan = zith::detail::scan;
+
+// ============================================================================
+// Byte scanners
+// ============================================================================
+
+TEST_CASE("LEXER: scanners stop at the right byte across block boundaries", "[lexer][scan]") {
+    // Every stop position from inside the first block to past the 32-byte one
+    for (size_t at = 0; at < 80; ++at) {
+        std::string blank(96, ' ');
+        for (size_t i = 0; i < at; ++i) blank[i] = "\t \r\f\v"[i % 5];
+        blank[at] = 'x';
+        REQUIRE(scan::skip_blank(blank.data(), blank.data() + blank.size()) == blank.data() + at);
+
+        std::string ident(96, 'a');
+        for (size_t i = 0; i < at; ++i) ident[i] = "aZ_09"[i % 5];
+        ident[at] = '-';
+        REQUIRE(scan::skip_ident(ident.data(), ident.data() + ident.size()) == ident.data() + at);
+
+        std::string body(96, 'y');
+        body[at] = '\\';
+        REQUIRE(scan::find3(body.data(), body.data() + body.size(), '"', '\\', '\n') == body.data() + at);
+        REQUIRE(scan::find2(body.data(), body.data() + body.size(), '*', '\n') == body.data() + body.size());
+    }
+}
+
+TEST_CASE("LEXER: scanners treat non-ASCII bytes as stops and respect end", "[lexer][scan]") {
+    const std::string s = "abc\xC3\xA9xyz";
+    REQUIRE(scan::skip_ident(s.data(), s.data() + s.size()) == s.data() + 3);
+
+    // '\n' ends a blank run; the byte past 'end' is never looked at
+    const std::string t = "    \n    ";
+    REQUIRE(scan::skip_blank(t.data(), t.data() + t.size()) == t.data() + 4);
+    REQUIRE(scan::skip_blank(t.data(), t.data() + 2) == t.data() + 2);
+}
+
+// ============================================================================
+// Tokenizer
+// ============================================================================
+
+TEST_CASE("LEXER: long runs keep token positions exact", "[lexer]") {
+    const std::string ident(70, 'q');
+    const std::string src = std::string(40, ' ') + ident + "\n" +
+                            "/* " + std::string(50, '*') + "\n" + std::string(40, 'c') + " */ x\n" +
+                            "\"" + std::string(45, 's') + "\\n\" // " + std::string(60, '-') + "\n" +
+                            "y";
+
+    ZithArena *arena = zith_arena_create(0);
+    const ZithTokenStream ts = zith_tokenize(arena, src.data(), src.size());
+    REQUIRE(ts.data != nullptr);
+    REQUIRE(ts.len == 5);  // ident, x, string, y, END
+
+    ZithLineIndex lines{};
+    REQUIRE(zith_line_index_build(arena, src.data(), src.size(), &lines));
+    auto at = [&](const size_t i) { return zith_line_index_resolve(&lines, ts.data[i].loc.offset); };
+
+    for (size_t i = 0; i < ts.len - 1; ++i)
+        REQUIRE(ts.data[i].loc.offset == static_cast<size_t>(ts.data[i].lexeme.data - src.data()));
+
+    REQUIRE(ts.data[0].type == ZITH_TOKEN_IDENTIFIER);
+    REQUIRE(ts.data[0].lexeme.len == 70);
+    REQUIRE(at(0).line == 1);
+    REQUIRE(at(0).column == 41);
+
+    REQUIRE(std::string(ts.data[1].lexeme.data, ts.data[1].lexeme.len) == "x");
+    REQUIRE(at(1).line == 3);
+    REQUIRE(at(1).column == 45);
+
+    REQUIRE(ts.data[2].type == ZITH_TOKEN_STRING);
+    REQUIRE(ts.data[2].lexeme.len == 49);
+    REQUIRE(at(2).line == 4);
+    REQUIRE(at(2).column == 1);
+
+    REQUIRE(at(3).line == 5);
+    REQUIRE(ts.data[4].type == ZITH_TOKEN_END);
+    REQUIRE(ts.data[4].loc.offset == src.size());
+
+    zith_arena_destroy(arena);
+}
+
+TEST_CASE("LEXER: character classes are ASCII and locale-independent", "[lexer]") {
+    namespace chars = zith::detail::chars;
+    for (unsigned c = 0x80; c < 0x100; ++c) {
+        const auto b = static_cast<unsigned char>(c);
+        REQUIRE(chars::lead(b) == chars::Lead::Other);
+        REQUIRE_FALSE(chars::is_ident(b));
+    }
+    REQUIRE(chars::lead('\v') == chars::Lead::Blank);
+    REQUIRE(chars::lead('"') == chars::Lead::Quote);
+    REQUIRE(chars::lead('/') == chars::Lead::Slash);
+    REQUIRE(chars::lead('~') == chars::Lead::Operator);
+    REQUIRE(chars::lead('$') == chars::Lead::Other);
+    REQUIRE(chars::to_lower('X') == 'x');
+    REQUIRE(chars::to_lower('[') == '[');
+
+    // '0X1F' and '.5' take the number path; a letter suffix is still an error
+    ZithArena *arena = zith_arena_create(0);
+    const std::string src = "0X1F .5 x.y";
+    const ZithTokenStream ts = zith_tokenize(arena, src.data(), src.size());
+    REQUIRE(ts.len == 6);
+    REQUIRE(ts.data[0].type == ZITH_TOKEN_HEXADECIMAL);
+    REQUIRE(ts.data[1].type == ZITH_TOKEN_FLOAT);
+    REQUIRE(ts.data[2].type == ZITH_TOKEN_IDENTIFIER);
+    REQUIRE(ts.data[3].type == ZITH_TOKEN_DOT);
+    REQUIRE(zith_tokenize(arena, "12ab", 4).data == nullptr);
+    zith_arena_destroy(arena);
+}
+
+TEST_CASE("LEXER: punctuation table agrees with the keyword lookup", "[lexer]") {
+    // Every 1-3 byte string over the operator bytes: the table must pick the
+    // same longest match as trying lengths 3, 2, 1 through the perfect hash
+    const std::string bytes = "()[]{};,:?@#~+-*/%^&|=!<>.a";
+    for (const char a: bytes)
+        for (const char b: bytes + '\0')
+            for (const char c: bytes + '\0') {
+                std::string s(1, a);
+                if (b) s += b;
+                if (b && c) s += c;
+
+                ZithTokenType want = ZITH_TOKEN_UNKNOWN;
+                size_t want_len = 0;
+                for (size_t len = s.size(); len > 0 && !want_len; --len) {
+                    const ZithTokenType t = zith_lookup_keyword(s.data(), len);
+                    const bool single_delim = len == 1 && std::strchr("(){}[];,:?@#~", a);
+                    if (t != ZITH_TOKEN_IDENTIFIER || single_delim) {
+                        want = t;
+                        want_len = len;
+                    }
+                }
+
+                const auto m = zith::detail::punct::match(s.data(), s.data() + s.size());
+                INFO(s);
+                REQUIRE(m.len == want_len);
+                if (want_len) REQUIRE(m.type == want);
+            }
+}
+
+TEST_CASE("LEXER: lexemes point into the source instead of arena copies", "[lexer]") {
+    const std::string src = "fn main() { x := \"hi\" + 0x1F; }";
+
+    ZithArena *arena = zith_arena_create(0);
+    const ZithTokenStream ts = zith_tokenize(arena, src.data(), src.size());
+    REQUIRE(ts.data != nullptr);
+
+    for (size_t i = 0; i < ts.len; ++i) {
+        const ZithStr &lex = ts.data[i].lexeme;
+        REQUIRE(lex.data >= src.data());
+        REQUIRE(lex.data + lex.len <= src.data() + src.size());
+    }
+    // Single-character punctuation included: '(' is at offset 7
+    REQUIRE(ts.data[2].lexeme.data == src.data() + 7);
+    REQUIRE(ts.data[ts.len - 1].lexeme.data == src.data() + src.size());
+
+    // Only the token array itself was allocated
+    ZithArenaStats stats{};
+    zith_arena_get_stats(arena, &stats);
+    REQUIRE(stats.used <= ts.len * sizeof(ZithToken) * 4);
+
+    zith_arena_destroy(arena);
+}
+
+TEST_CASE("LEXER: SoA stream matches the token stream", "[lexer][soa]") {
+    const std::string src = "fn f(a: i32) {\n  return a * 2;\n}\n/* x\n y */ \"s\\n\" 0x1F\n";
+
+    ZithArena *arena = zith_arena_create(0);
+    const ZithTokenStream ts = zith_tokenize(arena, src.data(), src.size());
+    ZithTokenStreamSoA soa = zith_tokenize_soa(arena, src.data(), src.size());
+    REQUIRE(ts.data != nullptr);
+    REQUIRE(ts.types != nullptr);
+    REQUIRE(soa.len == ts.len);
+    REQUIRE(soa.lines.starts == nullptr);  // built on demand
+
+    ZithLineIndex lines{};
+    REQUIRE(zith_line_index_build(arena, src.data(), src.size(), &lines));
+
+    for (size_t i = 0; i < ts.len; ++i) {
+        const ZithToken t = zith_token_soa_at(&soa, i);
+        REQUIRE(t.type == ts.data[i].type);
+        REQUIRE(ts.types[i] == ts.data[i].type);
+        REQUIRE(t.lexeme.data == ts.data[i].lexeme.data);
+        REQUIRE(t.lexeme.len == ts.data[i].lexeme.len);
+        REQUIRE(t.loc.offset == ts.data[i].loc.offset);
+
+        const ZithLineCol a = zith_token_soa_loc(&soa, i);
+        const ZithLineCol b = zith_line_index_resolve(&lines, ts.data[i].loc.offset);
+        REQUIRE(a.line == b.line);
+        REQUIRE(a.column == b.column);
+    }
+    REQUIRE(soa.lines.starts != nullptr);
+    REQUIRE(soa.lines.count == 6);  // five newlines
+
+    // Lexical errors leave the stream empty
+    REQUIRE(zith_tokenize_soa(arena, "1x", 2).types == nullptr);
+    zith_arena_destroy(arena);
+}
+
+TEST_CASE("LEXER: line index resolves offsets to 1-based line and column", "[lexer]") {
+    const std::string src = "ab\n\ncd\n";
+    ZithArena *arena = zith_arena_create(0);
+    ZithLineIndex lines{};
+    REQUIRE(zith_line_index_build(arena, src.data(), src.size(), &lines));
+    REQUIRE(lines.count == 4);
+
+    auto check = [&](const size_t offset, const size_t line, const size_t column) {
+        const ZithLineCol lc = zith_line_index_resolve(&lines, offset);
+        REQUIRE(lc.line == line);
+        REQUIRE(lc.column == column);
+    };
+    check(0, 1, 1);
+    check(2, 1, 3);  // the '\n' itself belongs to its line
+    check(3, 2, 1);
+    check(4, 3, 1);
+    check(5, 3, 2);
+    check(7, 4, 1);  // end of input after the last newline
+
+    // No index: everything is on line 1
+    REQUIRE(zith_line_index_resolve(nullptr, 9).column == 10);
+    zith_arena_destroy(arena);
+}
+
+TEST_CASE("LEXER: numeric literal values are computed while lexing", "[lexer][numbers]") {
+    const std::string src =
+        "a 0xFF 0b1010 0o17 1'000'000 9223372036854775807 9223372036854775808 "
+        "18446744073709551615 0xFFFF'FFFF'FFFF'FFFF 1.5 .25 0.1 3.14159 "
+        "123456789012345678901234.5 0.000000000000000000000000001";
+    ZithArena *arena = zith_arena_create(0);
+    const ZithTokenStream s = zith_tokenize(arena, src.data(), src.size());
+    REQUIRE(s.data != nullptr);
+    REQUIRE(s.number_count == 14);
+
+    auto num = [&](const size_t token) {
+        const ZithNumber *n = zith_token_number(&s, s.data[token].loc.offset);
+        REQUIRE(n != nullptr);
+        return *n;
+    };
+    REQUIRE(zith_token_number(&s, s.data[0].loc.offset) == nullptr);  // identifier
+
+    REQUIRE(num(1).kind == ZITH_NUMBER_UINT);
+    REQUIRE(num(1).value.u64 == 0xFF);
+    REQUIRE(num(2).value.u64 == 10);
+    REQUIRE(num(3).value.u64 == 15);
+    REQUIRE(num(4).kind == ZITH_NUMBER_INT);
+    REQUIRE(num(4).value.i64 == 1000000);
+    REQUIRE(num(5).value.i64 == INT64_MAX);
+    REQUIRE(num(6).kind == ZITH_NUMBER_UINT);
+    REQUIRE(num(6).value.u64 == uint64_t{1} << 63);
+    REQUIRE(num(7).value.u64 == UINT64_MAX);
+    REQUIRE(num(8).value.u64 == UINT64_MAX);
+
+    // Floats must round exactly like strtod, fast path or not
+    for (size_t i = 9; i < 15; ++i) {
+        const std::string text(s.data[i].lexeme.data, s.data[i].lexeme.len);
+        REQUIRE(num(i).kind == ZITH_NUMBER_FLOAT);
+        REQUIRE(num(i).value.f64 == std::strtod(text.c_str(), nullptr));
+    }
+
+    // Integers that do not fit 64 bits are lexical errors
+    for (const char *bad: {"18446744073709551616", "0x1'0000'0000'0000'0000", "0b" "1" "0000000000000000"
+                           "000000000000000000000000000000000000000000000000"}) {
+        REQUIRE(zith_tokenize(arena, bad, std::strlen(bad)).data == nullptr);
+    }
+    zith_arena_destroy(arena);
+}
+
+TEST_CASE("LEXER: float fast path agrees with strtod", "[lexer][numbers]") {
+    uint32_t rng = 777;
+    auto next_rand = [&rng] { return rng = rng * 1103515245u + 12345u, rng >> 8; };
+
+    std::string src;
+    for (int i = 0; i < 2000; ++i) {
+        std::string lit = std::to_string(next_rand() % 100000) + "." + std::to_string(next_rand());
+        src += lit + " ";
+    }
+    ZithArena *arena = zith_arena_create(0);
+    const ZithTokenStream s = zith_tokenize(arena, src.data(), src.size());
+    REQUIRE(s.number_count == 2000);
+    for (size_t i = 0; i < s.number_count; ++i) {
+        const std::string text(s.data[i].lexeme.data, s.data[i].lexeme.len);
+        REQUIRE(s.numbers[i].value.f64 == std::strtod(text.c_str(), nullptr));
+    }
+    zith_arena_destroy(arena);
+}
+
+// ============================================================================
+// Incremental re-lexing
+// ============================================================================
+
+static void require_same_tokens(const ZithTokenStream &a, const ZithTokenStream &b, const std::string &src) {
+    REQUIRE(a.data != nullptr);
+    REQUIRE(b.data != nullptr);
+    REQUIRE(a.len == b.len);
+    for (size_t i = 0; i < a.len; ++i) {
+        REQUIRE(a.data[i].type == b.data[i].type);
+        REQUIRE(a.types[i] == b.types[i]);
+        REQUIRE(a.data[i].loc.offset == b.data[i].loc.offset);
+        REQUIRE(a.data[i].lexeme.len == b.data[i].lexeme.len);
+        REQUIRE(a.data[i].lexeme.data == src.data() + a.data[i].loc.offset);
+    }
+    REQUIRE(a.number_count == b.number_count);
+    for (size_t i = 0; i < a.number_count; ++i) {
+        REQUIRE(a.numbers[i].offset == b.numbers[i].offset);
+        REQUIRE(a.numbers[i].kind == b.numbers[i].kind);
+        REQUIRE(a.numbers[i].value.u64 == b.numbers[i].value.u64);
+    }
+}
+
+TEST_CASE("LEXER: incremental re-lex matches a full lex", "[lexer][incremental]") {
+    std::string src;
+    for (int i = 0; i < 30; ++i)
+        src += "fn f" + std::to_string(i) + "(a: i32) -> i32 { let s = \"x\" ; return a << 2 + 0x1F; }\n";
+
+    // Each edit: position, bytes removed, bytes inserted
+    struct Edit { size_t at; size_t remove; std::string insert; };
+    const Edit edits[] = {
+        {3, 0, "g"},            // grows an identifier
+        {2, 1, ""},             // 'fn f0' -> 'fnf0': merges two tokens
+        {200, 0, " */"},        // lexes as '*' '/' ...
+        {120, 0, "/* "},        // ... until this comments out the text between
+        {300, 0, "\n\n"},       // blank lines only
+        {50, 0, ".5"},          // '2' then '.5' becomes '2.5'
+        {60, 0, ". .."},        // '.' '.' '.' ...
+        {61, 1, ""},            // ... until '.' then '..' becomes '...'
+        {500, 3, "abc def"},
+        {0, 0, "import std/io;\n"},
+        {0, 0, ""},             // no-op
+    };
+
+    ZithArena *arena = zith_arena_create(0);
+    ZithTokenStream prev = zith_tokenize(arena, src.data(), src.size());
+    REQUIRE(prev.data != nullptr);
+
+    // Each edit builds on the previous source and stream
+    std::string cur = src;
+    for (const Edit &e: edits) {
+        std::string next = cur;
+        next.replace(e.at, e.remove, e.insert);
+        const ZithSourceEdit edit{e.at, e.at + e.remove, e.at + e.insert.size()};
+
+        const ZithTokenStream inc = zith_tokenize_incremental(arena, prev, edit, next.data(), next.size());
+        const ZithTokenStream full = zith_tokenize(arena, next.data(), next.size());
+        require_same_tokens(inc, full, next);
+
+        cur = std::move(next);
+        prev = inc;
+    }
+
+    // An edit that does not fit the previous stream falls back to a full lex
+    const ZithTokenStream bad = zith_tokenize_incremental(arena, prev, {10, 5, 1}, cur.data(), cur.size());
+    require_same_tokens(bad, zith_tokenize(arena, cur.data(), cur.size()), cur);
+
+    zith_arena_destroy(arena);
+}
+
+TEST_CASE("LEXER: incremental re-lex survives random single-byte edits", "[lexer][incremental]") {
+    std::string cur;
+    for (int i = 0; i < 8; ++i) cur += "let v" + std::to_string(i) + " = a.b <<= 1.5 + x; // c\n";
+
+    ZithArena *arena = zith_arena_create(0);
+    ZithTokenStream prev = zith_tokenize(arena, cur.data(), cur.size());
+    REQUIRE(prev.data != nullptr);
+
+    static constexpr char kBytes[] = " a1.<=/*\n_-";
+    uint32_t rng = 12345;
+    auto next_rand = [&rng] { return rng = rng * 1103515245u + 12345u, rng >> 8; };
+
+    for (int step = 0; step < 400; ++step) {
+        std::string next = cur;
+        const size_t at = next_rand() % (next.size() + 1);
+        const bool erase = (next_rand() & 1) && at < next.size();
+        if (erase) next.erase(at, 1);
+        else next.insert(at, 1, kBytes[next_rand() % (sizeof(kBytes) - 1)]);
+        const ZithSourceEdit edit{at, at + (erase ? 1 : 0), at + (erase ? 0 : 1)};
+
+        const ZithTokenStream full = zith_tokenize(arena, next.data(), next.size());
+        const ZithTokenStream inc = zith_tokenize_incremental(arena, prev, edit, next.data(), next.size());
+        if (!full.data) {
+            REQUIRE(inc.data == nullptr);
+            continue;  // keep the last valid source
+        }
+        require_same_tokens(inc, full, next);
+        cur = std::move(next);
+        prev = inc;
+    }
+    zith_arena_destroy(arena);
+}
+
+// ============================================================================
+// Parallel lexing
+// ============================================================================
+
+TEST_CASE("LEXER: parallel lexing of a large source matches the serial lexer", "[lexer][parallel]") {
+    // Strings and comments that span lines, with quotes, slashes and stars
+    // inside them, so the split pre-pass has something to get wrong
+    const std::string unit =
+        "fn f(a: i32) -> i32 { let s = \"line one\\\"\n // not a comment /* nor this\"; return a; }\n"
+        "/* block\n \"not a string\n ** still comment */ let x = 1.5 / 2;\n"
+        "// line comment with \" quote\n";
+    std::string src;
+    while (src.size() < 3u * 1024 * 1024) src += unit;
+
+    ZithArena *arena = zith_arena_create(0);
+    const ZithTokenStream serial = zith_tokenize(arena, src.data(), src.size());
+    REQUIRE(serial.data != nullptr);
+
+    for (const size_t threads: {2u, 3u, 8u}) {
+        const ZithTokenStream par = zith_tokenize_parallel(arena, src.data(), src.size(), threads);
+        require_same_tokens(par, serial, src);
+    }
+
+    // Small inputs and single-threaded requests take the serial path
+    const std::string small = "let x = 1;";
+    REQUIRE(zith_tokenize_parallel(arena, small.data(), small.size(), 8).len == 6);
+
+    // Errors are reported by a serial re-lex: same (empty) result
+    src += "\"unterminated";
+    REQUIRE(zith_tokenize_parallel(arena, src.data(), src.size(), 4).data == nullptr);
+
+    zith_arena_destroy(arena);
+}
+
+// ============================================================================
+// Streaming
+// ============================================================================
+
+namespace {
+    struct StringInput {
+        const std::string *src;
+        size_t pos;
+        size_t step;  // at most this many bytes per read
+    };
+
+    ptrdiff_t read_string(void *ctx, char *buf, const size_t cap) {
+        auto *in = static_cast<StringInput *>(ctx);
+        const size_t n = std::min({cap, in->step, in->src->size() - in->pos});
+        std::memcpy(buf, in->src->data() + in->pos, n);
+        in->pos += n;
+        return static_cast<ptrdiff_t>(n);
+    }
+}
+
+TEST_CASE("LEXER: streaming lexer matches the token stream for any chunk size", "[lexer][stream]") {
+    // A string and a comment longer than the smaller chunks, and operators
+    // that straddle read boundaries
+    std::string src = "fn main() -> i32 {\n    let s = \"" + std::string(300, 'x') + "\\n\";\n"
+                      "    /* " + std::string(200, '*') + " */ x <<= 0x1F; y ... 1.25 // tail\n}\n";
+    for (int i = 0; i < 200; ++i) src += "let v" + std::to_string(i) + " := a->b + " + std::to_string(i) + ";\n";
+
+    ZithArena *arena = zith_arena_create(0);
+    const ZithTokenStream whole = zith_tokenize(arena, src.data(), src.size());
+    REQUIRE(whole.data != nullptr);
+
+    for (const size_t step: {1u, 7u, 64u, 100000u}) {
+        StringInput in{&src, 0, step};
+        ZithLexer *lx = zith_lexer_create(read_string, &in, step < 64 ? 16 : 0);
+        REQUIRE(lx != nullptr);
+
+        for (size_t i = 0; i < whole.len; ++i) {
+            // Lookahead sees exactly what next() will return
+            const ZithToken *ahead = zith_lexer_peek(lx, 3);
+            const size_t ai = std::min(i + 3, whole.len - 1);
+            REQUIRE(ahead != nullptr);
+            REQUIRE(ahead->loc.offset == whole.data[ai].loc.offset);
+
+            const ZithToken *t = zith_lexer_next(lx);
+            REQUIRE(t != nullptr);
+            REQUIRE(t->type == whole.data[i].type);
+            REQUIRE(t->loc.offset == whole.data[i].loc.offset);
+            REQUIRE(std::string_view(t->lexeme.data, t->lexeme.len) ==
+                    std::string_view(whole.data[i].lexeme.data, whole.data[i].lexeme.len));
+        }
+        // END repeats
+        REQUIRE(zith_lexer_next(lx)->type == ZITH_TOKEN_END);
+        REQUIRE_FALSE(zith_lexer_failed(lx));
+        zith_lexer_destroy(lx);
+    }
+    zith_arena_destroy(arena);
+}
+
+TEST_CASE("LEXER: streaming lexer reads large inputs in small windows and reports errors", "[lexer][stream]") {
+    const std::string unit = "let value = other + 42; // comment\n";
+    std::string src;
+    while (src.size() < 4u * 1024 * 1024) src += unit;
+
+    StringInput in{&src, 0, SIZE_MAX};
+    ZithLexer *lx = zith_lexer_create(read_string, &in, 4096);
+    size_t count = 0;
+    for (const ZithToken *t; (t = zith_lexer_next(lx)) && t->type != ZITH_TOKEN_END;) ++count;
+    REQUIRE(count == src.size() / unit.size() * 7);
+    zith_lexer_destroy(lx);
+
+    // Errors past the first chunk: nothing more comes out
+    std::string bad = src.substr(0, 100000) + "let s = \"unterminated";
+    StringInput bin{&bad, 0, SIZE_MAX};
+    lx = zith_lexer_create(read_string, &bin, 4096);
+    const ZithToken *t = nullptr;
+    while ((t = zith_lexer_next(lx)) && t->type != ZITH_TOKEN_END) {}
+    REQUIRE(t == nullptr);
+    REQUIRE(zith_lexer_failed(lx));
+    zith_lexer_destroy(lx);
+
+    REQUIRE(zith_lexer_peek(nullptr, 0) == nullptr);
+}